@@ -0,0 +1,3006 @@
+// hanoi.c - libhanoi: the solver engines, random access, state-space
+// search, move traces and the move-stream validator (see hanoi.h)
+#ifdef __linux__
+#define _GNU_SOURCE             // sched_setaffinity
+#endif
+#include <stdio.h>
+#include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "hanoi_internal.h"
+
+// ═══════════════════════════════════════════════════════════
+//  UTILITY FUNCTIONS
+// ═══════════════════════════════════════════════════════════
+// Decimal HanoiMoveIndex; rejects signs, junk and overflow
+int hanoiParseMoveIndex(const char *text, HanoiMoveIndex *out) {
+    HanoiMoveIndex value = 0;
+    if (*text == '\0') return 0;
+    for (const char *c = text; *c; c++) {
+        if (*c < '0' || *c > '9') return 0;
+        HanoiMoveIndex next = value * 10 + (*c - '0');
+        if ((next - (*c - '0')) / 10 != value) return 0;
+        value = next;
+    }
+    *out = value;
+    return 1;
+}
+
+// Decimal text of v in out (at least 40 bytes); returns out
+char *hanoiFormatMoveIndex(HanoiMoveIndex v, char *out) {
+    char digits[40];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + (int)(v % 10));
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < len; i++) out[i] = digits[len - 1 - i];
+    out[len] = '\0';
+    return out;
+}
+
+// Monotonic wall clock in nanoseconds
+long long hanoiNowNs() {
+    #ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (long long)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+    #else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    #endif
+}
+
+// ═══════════════════════════════════════════════════════════
+//  THREADING
+// ═══════════════════════════════════════════════════════════
+int hanoiHardwareThreads() {
+    #ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+    #else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+    #endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI workerEntry(LPVOID arg) {
+    WorkerStart *start = (WorkerStart *)arg;
+    start->fn(start->id, start->ctx);
+    return 0;
+}
+#else
+static void *workerEntry(void *arg) {
+    WorkerStart *start = (WorkerStart *)arg;
+    start->fn(start->id, start->ctx);
+    return NULL;
+}
+#endif
+
+// Run fn(id, ctx) for id = 0..threads-1 on separate threads (id 0 on the
+// calling thread) and wait for all of them
+void hanoiParallelRun(int threads, WorkerFunction fn, void *ctx) {
+    WorkerStart starts[HANOI_MAX_THREADS];
+    #ifdef _WIN32
+    HANDLE handles[HANOI_MAX_THREADS];
+    #else
+    pthread_t handles[HANOI_MAX_THREADS];
+    #endif
+    
+    if (threads < 1) threads = 1;
+    if (threads > HANOI_MAX_THREADS) threads = HANOI_MAX_THREADS;
+    
+    for (int t = 1; t < threads; t++) {
+        starts[t].fn = fn;
+        starts[t].id = t;
+        starts[t].ctx = ctx;
+        #ifdef _WIN32
+        handles[t] = CreateThread(NULL, 0, workerEntry, &starts[t], 0, NULL);
+        #else
+        pthread_create(&handles[t], NULL, workerEntry, &starts[t]);
+        #endif
+    }
+    
+    fn(0, ctx);
+    
+    for (int t = 1; t < threads; t++) {
+        #ifdef _WIN32
+        WaitForSingleObject(handles[t], INFINITE);
+        CloseHandle(handles[t]);
+        #else
+        pthread_join(handles[t], NULL);
+        #endif
+    }
+}
+
+void hanoiBarrierInit(Barrier *b, int count) {
+    b->count = count;
+    b->waiting = 0;
+    b->generation = 0;
+    #ifdef _WIN32
+    InitializeCriticalSection(&b->lock);
+    InitializeConditionVariable(&b->wake);
+    #else
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->wake, NULL);
+    #endif
+}
+
+void hanoiBarrierDestroy(Barrier *b) {
+    #ifdef _WIN32
+    DeleteCriticalSection(&b->lock);
+    #else
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->wake);
+    #endif
+}
+
+// Block until `count` threads have arrived
+void hanoiBarrierWait(Barrier *b) {
+    #ifdef _WIN32
+    EnterCriticalSection(&b->lock);
+    unsigned generation = b->generation;
+    if (++b->waiting == b->count) {
+        b->waiting = 0;
+        b->generation++;
+        WakeAllConditionVariable(&b->wake);
+    } else {
+        while (generation == b->generation) SleepConditionVariableCS(&b->wake, &b->lock, INFINITE);
+    }
+    LeaveCriticalSection(&b->lock);
+    #else
+    pthread_mutex_lock(&b->lock);
+    unsigned generation = b->generation;
+    if (++b->waiting == b->count) {
+        b->waiting = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->wake);
+    } else {
+        while (generation == b->generation) pthread_cond_wait(&b->wake, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+    #endif
+}
+
+void hanoiThreadStart(Thread *t, WorkerFunction fn, int id, void *ctx) {
+    t->start.fn = fn;
+    t->start.id = id;
+    t->start.ctx = ctx;
+    #ifdef _WIN32
+    t->handle = CreateThread(NULL, 0, workerEntry, &t->start, 0, NULL);
+    #else
+    pthread_create(&t->handle, NULL, workerEntry, &t->start);
+    #endif
+}
+
+void hanoiThreadJoin(Thread *t) {
+    #ifdef _WIN32
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+    #else
+    pthread_join(t->handle, NULL);
+    #endif
+}
+
+void hanoiSleepMs(int ms) {
+    #ifdef _WIN32
+    Sleep(ms);
+    #else
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+    #endif
+}
+
+// Pin the calling thread to one CPU; returns 0 where that is not supported
+int hanoiPinToCpu(int cpu) {
+    #ifdef _WIN32
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+    #elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+    #else
+    (void)cpu;
+    return 0;
+    #endif
+}
+
+// First CPU listed in /sys/devices/system/cpu/isolated (isolcpus=), or the
+// last online CPU when none is isolated
+int hanoiQuietCpu() {
+    int cpu = hanoiHardwareThreads() - 1;
+    #ifdef __linux__
+    FILE *f = fopen("/sys/devices/system/cpu/isolated", "r");
+    if (f) {
+        int isolated;
+        if (fscanf(f, "%d", &isolated) == 1) cpu = isolated;
+        fclose(f);
+    }
+    #endif
+    return cpu;
+}
+
+// Every heap allocation in the library goes through these, so --perf can
+// count them without replacing the process allocator
+unsigned long long hanoiAllocationCount = 0;
+
+void *hanoiMalloc(size_t size) {
+    __atomic_fetch_add(&hanoiAllocationCount, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+void *hanoiCalloc(size_t count, size_t size) {
+    __atomic_fetch_add(&hanoiAllocationCount, 1, __ATOMIC_RELAXED);
+    return calloc(count, size);
+}
+
+void *hanoiRealloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&hanoiAllocationCount, 1, __ATOMIC_RELAXED);
+    return realloc(ptr, size);
+}
+
+THREAD_LOCAL Arena *hanoiThreadArena = NULL;
+
+int hanoiArenaInit(Arena *a, size_t capacity) {
+    a->base = (unsigned char *)hanoiMalloc(capacity);
+    a->capacity = a->base ? capacity : 0;
+    a->used = 0;
+    return a->base != NULL;
+}
+
+void hanoiArenaFree(Arena *a) {
+    free(a->base);
+    a->base = NULL;
+    a->capacity = a->used = 0;
+}
+
+// 16-byte aligned block, or NULL when the arena is full
+void *hanoiArenaAlloc(Arena *a, size_t size) {
+    size_t offset = (a->used + 15) & ~(size_t)15;
+    if (!a->base || offset + size > a->capacity) return NULL;
+    a->used = offset + size;
+    return a->base + offset;
+}
+
+size_t hanoiArenaMark() {
+    return hanoiThreadArena ? hanoiThreadArena->used : 0;
+}
+
+void hanoiArenaRelease(size_t mark) {
+    if (hanoiThreadArena) hanoiThreadArena->used = mark;
+}
+
+int hanoiArenaOwns(const void *p) {
+    return hanoiThreadArena && (const unsigned char *)p >= hanoiThreadArena->base
+        && (const unsigned char *)p < hanoiThreadArena->base + hanoiThreadArena->capacity;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  RECURSIVE IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════
+static inline void hanoiRecord(HanoiContext *ctx, int disk, char source, char dest) {
+    if (ctx->out) ctx->out[ctx->moves] = HANOI_PACK_MOVE(disk, source - 'A', dest - 'A');
+    ctx->moves++;
+}
+
+void hanoi(HanoiContext *ctx, int n, char source, char dest, char aux) {
+    if (n == 1) {
+        hanoiRecord(ctx, 1, source, dest);
+        return;
+    }
+    hanoi(ctx, n - 1, source, aux, dest);
+    hanoiRecord(ctx, n, source, dest);
+    hanoi(ctx, n - 1, aux, dest, source);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  PARALLEL RECURSIVE ENGINE (WORK STEALING)
+// ═══════════════════════════════════════════════════════════
+// The top `depth` levels of the recursion are unrolled into 2^depth leaf
+// tasks of n - depth disks, separated by the 2^depth - 1 moves of the
+// larger disks. Every task has a fixed place in the output, so each one
+// writes its own slice and the slices are already in order when the
+// workers finish. Each worker owns a contiguous range of task indices,
+// packed as lo << 32 | hi in one word: the owner takes from the low end,
+// idle workers steal from the high end, both with a single CAS.
+#define PARALLEL_TASKS_PER_THREAD 16
+
+typedef struct {
+    char source, dest, aux;
+} ParallelTask;
+
+typedef struct {
+    uint64_t range;
+    unsigned long long moves;
+    char pad[48];                 // one cache line per worker
+} ParallelDeque;
+
+typedef struct {
+    int threads;
+    int leafDisks;
+    ParallelTask *tasks;
+    HanoiPackedMove *out;
+    ParallelDeque deques[HANOI_MAX_THREADS];
+} ParallelSolve;
+
+int hanoiParallelThreads = 0;     // 0 = all cores
+
+int hanoiParallelThreadCount() {
+    int threads = hanoiParallelThreads > 0 ? hanoiParallelThreads : hanoiHardwareThreads();
+    return threads > HANOI_MAX_THREADS ? HANOI_MAX_THREADS : threads;
+}
+
+// Leaf tasks in solution order; the moves of the unrolled disks go straight
+// to their slots in out
+static void parallelSplit(ParallelTask *tasks, int *count, HanoiPackedMove *out, unsigned long long slot,
+                   int n, int levels, char source, char dest, char aux) {
+    if (levels == 0) {
+        ParallelTask t = { source, dest, aux };
+        tasks[(*count)++] = t;
+        return;
+    }
+    parallelSplit(tasks, count, out, slot, n - 1, levels - 1, source, aux, dest);
+    if (out) out[(unsigned long long)*count * slot - 1] = HANOI_PACK_MOVE(n, source - 'A', dest - 'A');
+    parallelSplit(tasks, count, out, slot, n - 1, levels - 1, aux, dest, source);
+}
+
+static void parallelRunTask(ParallelSolve *run, int id, uint32_t task) {
+    unsigned long long slot = 1ULL << run->leafDisks;
+    HanoiContext ctx = { 0, run->out ? run->out + task * slot : NULL };
+    ParallelTask *t = &run->tasks[task];
+    
+    hanoi(&ctx, run->leafDisks, t->source, t->dest, t->aux);
+    run->deques[id].moves += ctx.moves;
+}
+
+static void parallelWorker(int id, void *arg) {
+    ParallelSolve *run = (ParallelSolve *)arg;
+    
+    while (1) {
+        uint64_t *own = &run->deques[id].range;
+        uint64_t r = __atomic_load_n(own, __ATOMIC_ACQUIRE);
+        uint32_t lo = (uint32_t)(r >> 32), hi = (uint32_t)r;
+        
+        if (lo < hi) {
+            uint64_t next = (uint64_t)(lo + 1) << 32 | hi;
+            if (__atomic_compare_exchange_n(own, &r, next, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                parallelRunTask(run, id, lo);
+            }
+            continue;
+        }
+        
+        // Own range is empty: steal the last task of the first busy victim
+        int stolen = 0;
+        for (int v = 1; v < run->threads && !stolen; v++) {
+            uint64_t *victim = &run->deques[(id + v) % run->threads].range;
+            r = __atomic_load_n(victim, __ATOMIC_ACQUIRE);
+            lo = (uint32_t)(r >> 32);
+            hi = (uint32_t)r;
+            while (lo < hi && !stolen) {
+                uint64_t next = (uint64_t)lo << 32 | (hi - 1);
+                if (__atomic_compare_exchange_n(victim, &r, next, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    parallelRunTask(run, id, hi - 1);
+                    stolen = 1;
+                } else {
+                    lo = (uint32_t)(r >> 32);
+                    hi = (uint32_t)r;
+                }
+            }
+        }
+        if (!stolen) return;      // the task set is fixed, so nothing can appear later
+    }
+}
+
+// Solve n disks A -> C on `threads` workers, storing the moves in out when
+// it is not NULL (2^n - 1 entries). Returns the number of moves made.
+unsigned long long hanoiParallel(int n, int threads, HanoiPackedMove *out) {
+    ParallelSolve *run = (ParallelSolve *)hanoiCalloc(1, sizeof(ParallelSolve));
+    if (!run) return 0;
+    
+    if (threads < 1) threads = 1;
+    if (threads > HANOI_MAX_THREADS) threads = HANOI_MAX_THREADS;
+    
+    int depth = 0;
+    while ((1 << depth) < threads * PARALLEL_TASKS_PER_THREAD && depth < n - 1) depth++;
+    int taskCount = 1 << depth;
+    
+    run->threads = threads;
+    run->leafDisks = n - depth;
+    run->out = out;
+    run->tasks = (ParallelTask *)hanoiMalloc(taskCount * sizeof(ParallelTask));
+    if (!run->tasks) {
+        free(run);
+        return 0;
+    }
+    
+    int count = 0;
+    parallelSplit(run->tasks, &count, out, 1ULL << run->leafDisks, n, depth, 'A', 'C', 'B');
+    
+    for (int t = 0; t < threads; t++) {
+        uint32_t lo = (uint32_t)((long long)taskCount * t / threads);
+        uint32_t hi = (uint32_t)((long long)taskCount * (t + 1) / threads);
+        run->deques[t].range = (uint64_t)lo << 32 | hi;
+    }
+    
+    hanoiParallelRun(threads, parallelWorker, run);
+    
+    unsigned long long total = (unsigned long long)taskCount - 1;
+    for (int t = 0; t < threads; t++) total += run->deques[t].moves;
+    
+    free(run->tasks);
+    free(run);
+    return total;
+}
+
+void hanoiSolveParallel(int n) {
+    hanoiParallel(n, hanoiParallelThreadCount(), NULL);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  ITERATIVE IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════
+// s.arr is NULL when the allocation fails
+Stack hanoiStackCreate(int capacity) {
+    Stack s;
+    s.arr = (int *)hanoiMalloc(capacity * sizeof(int));
+    s.top = -1;
+    return s;
+}
+
+// Peg from the thread's arena when it has one, from the heap otherwise;
+// give it back with hanoiPegStackRelease
+Stack hanoiPegStackCreate(int capacity) {
+    if (hanoiThreadArena) {
+        Stack s;
+        s.arr = (int *)hanoiArenaAlloc(hanoiThreadArena, capacity * sizeof(int));
+        s.top = -1;
+        if (s.arr) return s;
+    }
+    return hanoiStackCreate(capacity);
+}
+
+void hanoiPegStackRelease(Stack *s) {
+    if (!hanoiArenaOwns(s->arr)) free(s->arr);
+    s->arr = NULL;
+}
+
+void hanoiStackPush(Stack *s, int value) {
+    s->arr[++(s->top)] = value;
+}
+
+int hanoiStackPop(Stack *s) {
+    if (s->top == -1) return 0;
+    return s->arr[(s->top)--];
+}
+
+int hanoiStackPeek(Stack *s) {
+    if (s->top == -1) return 0;
+    return s->arr[s->top];
+}
+
+void hanoiLegalMove(Stack *A, Stack *B, char nameA, char nameB) {
+    int topA = hanoiStackPeek(A);
+    int topB = hanoiStackPeek(B);
+    
+    if (topA == 0) {
+        hanoiStackPush(A, hanoiStackPop(B));
+    } else if (topB == 0) {
+        hanoiStackPush(B, hanoiStackPop(A));
+    } else if (topA > topB) {
+        hanoiStackPush(A, hanoiStackPop(B));
+    } else {
+        hanoiStackPush(B, hanoiStackPop(A));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BITBOARD IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════
+// Each peg is a 64-bit occupancy mask: bit d-1 set means disk d is on it.
+// Bit 63 is a floor under every peg, so an empty peg reports a "top disk"
+// larger than any real one and needs no special case. Supports n <= 63.
+THREAD_LOCAL Bitboard hanoiBitboardResult;   // final state of this thread's last hanoiSolveBitboard run
+
+// Legal move between two pegs: the top disk of a peg is its lowest set bit
+// (bit ctz(mask)), so the smaller top disk is the smaller isolated low bit.
+// Toggling that bit in both masks moves the disk whichever way it goes.
+#define BITBOARD_MOVE(x, y) do {                                  \
+        uint64_t topX = (x) & (0 - (x));                          \
+        uint64_t topY = (y) & (0 - (y));                          \
+        uint64_t bit = topX < topY ? topX : topY;                 \
+        (x) ^= bit;                                               \
+        (y) ^= bit;                                               \
+    } while (0)
+
+void hanoiSolveBitboard(int n) {
+    uint64_t src = BITBOARD_FLOOR | ((1ULL << n) - 1);
+    uint64_t aux = BITBOARD_FLOOR;
+    uint64_t dest = BITBOARD_FLOOR;
+    
+    // Same even/odd peg swap as the stack engine: for even n the cycle
+    // source -> aux -> dest runs with the roles of aux and dest exchanged
+    uint64_t *pegS = &src;
+    uint64_t *pegA = (n % 2 == 0) ? &dest : &aux;
+    uint64_t *pegD = (n % 2 == 0) ? &aux : &dest;
+    uint64_t s = *pegS, a = *pegA, d = *pegD;
+    
+    unsigned long long totalMoves = (1ULL << n) - 1;
+    
+    // Moves come in fixed triples (S-D, S-A, A-D), so no i % 3 is needed
+    for (unsigned long long t = totalMoves / 3; t > 0; t--) {
+        BITBOARD_MOVE(s, d);
+        BITBOARD_MOVE(s, a);
+        BITBOARD_MOVE(a, d);
+    }
+    if (totalMoves % 3 >= 1) BITBOARD_MOVE(s, d);
+    if (totalMoves % 3 == 2) BITBOARD_MOVE(s, a);
+    
+    *pegS = s; *pegA = a; *pegD = d;
+    hanoiBitboardResult.peg[0] = src;
+    hanoiBitboardResult.peg[1] = aux;
+    hanoiBitboardResult.peg[2] = dest;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  RANDOM ACCESS (K-TH MOVE AND STATES)
+// ═══════════════════════════════════════════════════════════
+// Move k (1 <= k <= 2^n - 1) of the optimal n-disk solution from A to C,
+// read straight from the bits of k: the disk is ctz(k) + 1, and the pegs
+// follow the binary solution for odd n. For even n the B and C roles are
+// swapped, exactly like the peg swap in runIterativeTest.
+HanoiMove hanoiKthMove(int n, unsigned long long k) {
+    HanoiMove m;
+    m.disk = __builtin_ctzll(k) + 1;
+    m.from = (int)((k & (k - 1)) % 3);
+    m.to = (int)(((k | (k - 1)) + 1) % 3);
+    
+    if (n % 2 == 0) {
+        // 2p mod 3 swaps pegs 1 and 2 and keeps peg 0
+        m.from = (2 * m.from) % 3;
+        m.to = (2 * m.to) % 3;
+    }
+    return m;
+}
+
+// Peg of every disk (pegOf[1..n]) after the first k moves of the optimal
+// solution, 0 <= k <= 2^n - 1. Walks from the largest disk down: disk d has
+// made its single move iff k >= 2^(d-1), which fixes the sub-problem for d-1.
+void hanoiStateAfter(int n, unsigned long long k, int *pegOf) {
+    int src = 0, aux = 1, dst = 2;
+    
+    for (int d = n; d >= 1; d--) {
+        unsigned long long half = 1ULL << (d - 1);
+        if (k < half) {
+            // Still moving the d-1 smaller disks from src to aux
+            pegOf[d] = src;
+            int t = aux; aux = dst; dst = t;
+        } else {
+            // Disk d is done; the d-1 smaller disks go from aux to dst
+            pegOf[d] = dst;
+            k -= half;
+            int t = src; src = aux; aux = t;
+        }
+    }
+}
+
+// Inverse of hanoiStateAfter. Returns 1 and stores the move index in *k when
+// the configuration lies on the optimal path, 0 otherwise.
+int hanoiStateIndex(int n, const int *pegOf, unsigned long long *k) {
+    int src = 0, aux = 1, dst = 2;
+    unsigned long long index = 0;
+    
+    for (int d = n; d >= 1; d--) {
+        if (pegOf[d] == src) {
+            int t = aux; aux = dst; dst = t;
+        } else if (pegOf[d] == dst) {
+            index += 1ULL << (d - 1);
+            int t = src; src = aux; aux = t;
+        } else {
+            return 0;
+        }
+    }
+    
+    *k = index;
+    return 1;
+}
+
+// 128-bit versions for n <= HANOI_MAX_DISKS, same rules as above. 2^64 is
+// 1 mod 3, so a 128-bit value is congruent to the sum of its two halves.
+int hanoiIndexMod3(HanoiMoveIndex k) {
+    return (int)(((uint64_t)k % 3 + (uint64_t)(k >> 64) % 3) % 3);
+}
+
+HanoiMove hanoiKthMove128(int n, HanoiMoveIndex k) {
+    HanoiMove m;
+    uint64_t low = (uint64_t)k;
+    m.disk = low ? __builtin_ctzll(low) + 1 : __builtin_ctzll((uint64_t)(k >> 64)) + 65;
+    m.from = hanoiIndexMod3(k & (k - 1));
+    m.to = hanoiIndexMod3((k | (k - 1)) + 1);
+    
+    if (n % 2 == 0) {
+        m.from = (2 * m.from) % 3;
+        m.to = (2 * m.to) % 3;
+    }
+    return m;
+}
+
+void hanoiStateAfter128(int n, HanoiMoveIndex k, int *pegOf) {
+    int src = 0, aux = 1, dst = 2;
+    
+    for (int d = n; d >= 1; d--) {
+        HanoiMoveIndex half = (HanoiMoveIndex)1 << (d - 1);
+        if (k < half) {
+            pegOf[d] = src;
+            int t = aux; aux = dst; dst = t;
+        } else {
+            pegOf[d] = dst;
+            k -= half;
+            int t = src; src = aux; aux = t;
+        }
+    }
+}
+
+int hanoiStateIndex128(int n, const int *pegOf, HanoiMoveIndex *k) {
+    int src = 0, aux = 1, dst = 2;
+    HanoiMoveIndex index = 0;
+    
+    for (int d = n; d >= 1; d--) {
+        if (pegOf[d] == src) {
+            int t = aux; aux = dst; dst = t;
+        } else if (pegOf[d] == dst) {
+            index += (HanoiMoveIndex)1 << (d - 1);
+            int t = src; src = aux; aux = t;
+        } else {
+            return 0;
+        }
+    }
+    
+    *k = index;
+    return 1;
+}
+
+// Rebuild the three Stack pegs (already created with capacity n) from pegOf
+void hanoiLoadStacks(int n, const int *pegOf, Stack pegs[3]) {
+    for (int p = 0; p < 3; p++) pegs[p].top = -1;
+    for (int d = n; d >= 1; d--) hanoiStackPush(&pegs[pegOf[d]], d);
+}
+
+// Read the peg of every disk back out of three Stack pegs
+void hanoiReadStacks(Stack pegs[3], int *pegOf) {
+    for (int p = 0; p < 3; p++) {
+        for (int i = 0; i <= pegs[p].top; i++) pegOf[pegs[p].arr[i]] = p;
+    }
+}
+
+// Configuration text: one peg letter per disk, smallest disk first ("AAB" =
+// disks 1 and 2 on A, disk 3 on B). Returns the disk count or -1.
+int hanoiParseConfig(const char *text, int *pegOf, int maxDisks) {
+    int n = (int)strlen(text);
+    if (n < 1 || n > maxDisks) return -1;
+    
+    for (int d = 1; d <= n; d++) {
+        char c = text[d - 1];
+        if (c >= 'a' && c <= 'c') c = c - 'a' + 'A';
+        if (c < 'A' || c > 'C') return -1;
+        pegOf[d] = c - 'A';
+    }
+    return n;
+}
+
+void hanoiFormatConfig(int n, const int *pegOf, char *out) {
+    for (int d = 1; d <= n; d++) out[d - 1] = 'A' + pegOf[d];
+    out[n] = '\0';
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BLOCK-DOUBLING GENERATOR
+// ═══════════════════════════════════════════════════════════
+// The n-disk solution is the (n-1)-disk solution with pegs relabelled, one
+// move of disk n, and the (n-1)-disk solution relabelled again. Unrolling
+// that down to k disks, the full stream is 2^(n-k) copies of one k-disk
+// base block, each under one of the six peg permutations, separated by
+// single moves of the larger disks. The base block is relabelled through
+// a nibble lookup table once per permutation; generation is then memcpy.
+static BlockTable blockTables[HANOI_BLOCK_DISKS + 1];
+
+// Permutations are identified by where canonical A (source) and C
+// (destination) go; canonical B takes the remaining peg
+static int permutationIndex(int src, int dst) {
+    return src * 3 + dst;
+}
+
+static int blockTableLock = 0;
+
+static int blockTableBuild(BlockTable *table, int k) {
+    // The canonical base block is the baked-in kernel table for k disks
+    size_t length = (1u << k) - 1;
+    const HanoiPackedMove *base = hanoiKernelTable(k);
+    
+    for (int src = 0; src < 3; src++) {
+        for (int dst = 0; dst < 3; dst++) {
+            if (src == dst) continue;
+            
+            // Lookup table on the low nibble (from << 2 | to)
+            int label[3] = { src, 3 - src - dst, dst };
+            HanoiPackedMove lut[16] = { 0 };
+            for (int f = 0; f < 3; f++) {
+                for (int t = 0; t < 3; t++) lut[f << 2 | t] = (HanoiPackedMove)(label[f] << 2 | label[t]);
+            }
+            
+            HanoiPackedMove *copy = (HanoiPackedMove *)hanoiMalloc(length * sizeof(HanoiPackedMove));
+            if (!copy) {
+                // Drop the copies already built so a later call starts clean
+                for (int i = 0; i < 9; i++) {
+                    free(table->copies[i]);
+                    table->copies[i] = NULL;
+                }
+                return 0;
+            }
+            for (size_t i = 0; i < length; i++) copy[i] = (base[i] & ~0xF) | lut[base[i] & 0xF];
+            table->copies[permutationIndex(src, dst)] = copy;
+        }
+    }
+    
+    table->length = length;
+    __atomic_store_n(&table->k, k, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Tables are built on first use; library callers may race here, so the
+// build runs under a spin lock and is published by the release store of k
+BlockTable *hanoiBlockTableFor(int k) {
+    BlockTable *table = &blockTables[k];
+    if (__atomic_load_n(&table->k, __ATOMIC_ACQUIRE) == k) return table;
+    
+    while (__atomic_exchange_n(&blockTableLock, 1, __ATOMIC_ACQUIRE)) hanoiSleepMs(0);
+    int ok = table->k == k || blockTableBuild(table, k);
+    __atomic_store_n(&blockTableLock, 0, __ATOMIC_RELEASE);
+    return ok ? table : NULL;
+}
+
+// Generate the n-disk solution (n <= 63) into out[0..capacity). Whenever the
+// next block does not fit, flush(out, used, ctx) is called and the buffer is
+// reused; with capacity >= 2^n - 1 the whole list lands in out and flush is
+// only called once at the end. capacity must be at least 2^HANOI_BLOCK_DISKS.
+// Returns the number of moves generated.
+unsigned long long hanoiBlockGenerate(int n, HanoiPackedMove *out, size_t capacity,
+                                         void (*flush)(const HanoiPackedMove *, size_t, void *), void *ctx) {
+    int k = n < HANOI_BLOCK_DISKS ? n : HANOI_BLOCK_DISKS;
+    BlockTable *table = hanoiBlockTableFor(k);
+    if (!table) return 0;
+    
+    unsigned long long blocks = 1ULL << (n - k);
+    size_t used = 0;
+    int src = 0;
+    
+    for (unsigned long long j = 0; j < blocks; j++) {
+        size_t needed = table->length + (j + 1 < blocks ? 1 : 0);
+        if (capacity - used < needed) {
+            if (flush) flush(out, used, ctx);
+            used = 0;
+        }
+        
+        // Block j carries the small tower from src to the peg left free by
+        // the next large-disk move (or to C after the last block)
+        int dst = 2;
+        HanoiMove big;
+        if (j + 1 < blocks) {
+            big = hanoiKthMove(n, (j + 1) << k);
+            dst = 3 - big.from - big.to;
+        }
+        
+        memcpy(out + used, table->copies[permutationIndex(src, dst)], table->length * sizeof(HanoiPackedMove));
+        used += table->length;
+        if (j + 1 < blocks) out[used++] = HANOI_PACK_MOVE(big.disk, big.from, big.to);
+        src = dst;
+    }
+    
+    if (flush) flush(out, used, ctx);
+    return (blocks << k) - 1;
+}
+
+THREAD_LOCAL unsigned long long hanoiBlockChecksum;   // keeps benchmark output observable
+
+static void blockChecksumFlush(const HanoiPackedMove *moves, size_t count, void *ctx) {
+    (void)ctx;
+    if (count) hanoiBlockChecksum += moves[count - 1] + count;
+}
+
+// Output chunk for the streaming engines: from the thread's arena in batch
+// workers, else from the heap (NULL when out of memory). Hand it back with
+// engineChunkRelease before releasing the arena mark.
+static HanoiPackedMove *engineChunk() {
+    HanoiPackedMove *chunk = hanoiThreadArena ? (HanoiPackedMove *)hanoiArenaAlloc(hanoiThreadArena, HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove)) : NULL;
+    if (chunk) return chunk;
+    return (HanoiPackedMove *)hanoiMalloc(HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove));
+}
+
+static void engineChunkRelease(HanoiPackedMove *chunk) {
+    if (!hanoiArenaOwns(chunk)) free(chunk);
+}
+
+void hanoiSolveBlockDoubling(int n) {
+    size_t mark = hanoiArenaMark();
+    HanoiPackedMove *out = engineChunk();
+
+    if (!out) return;
+    hanoiBlockGenerate(n, out, HANOI_BLOCK_CHUNK_MOVES, blockChecksumFlush, NULL);
+    engineChunkRelease(out);
+    hanoiArenaRelease(mark);
+}
+
+typedef struct {
+    int n;
+    unsigned long long k;
+    int same;
+} BlockCompare;
+
+static void blockCompareFlush(const HanoiPackedMove *moves, size_t count, void *ctx) {
+    BlockCompare *c = (BlockCompare *)ctx;
+    for (size_t i = 0; i < count; i++) {
+        HanoiMove m = hanoiKthMove(c->n, ++c->k);
+        if (moves[i] != HANOI_PACK_MOVE(m.disk, m.from, m.to)) c->same = 0;
+    }
+}
+
+// Every generated move equals the one hanoiKthMove reports
+int hanoiVerifyBlockDoubling(int n) {
+    BlockCompare compare = { n, 0, 1 };
+    HanoiPackedMove *chunk = (HanoiPackedMove *)hanoiMalloc(HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove));
+    if (!chunk) return 0;
+    
+    unsigned long long total = hanoiBlockGenerate(n, chunk, HANOI_BLOCK_CHUNK_MOVES, blockCompareFlush, &compare);
+    free(chunk);
+    return compare.same && total == compare.k && total == (1ULL << n) - 1;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  SPECIALISED SMALL-N KERNELS
+// ═══════════════════════════════════════════════════════════
+// The complete solutions for n <= HANOI_KERNEL_MAX_DISKS are baked into constant
+// tables by the preprocessor: KERNEL_k(s, d, a) unrolls the recursion of
+// hanoi() into the list of packed moves, so a small solve is one memcpy.
+#define KERNEL_MOVE(d, s, t)  HANOI_PACK_MOVE(d, s, t),
+#define KERNEL_1(s, d, a)   KERNEL_MOVE(1, s, d)
+#define KERNEL_2(s, d, a)   KERNEL_1(s, a, d)  KERNEL_MOVE(2, s, d)  KERNEL_1(a, d, s)
+#define KERNEL_3(s, d, a)   KERNEL_2(s, a, d)  KERNEL_MOVE(3, s, d)  KERNEL_2(a, d, s)
+#define KERNEL_4(s, d, a)   KERNEL_3(s, a, d)  KERNEL_MOVE(4, s, d)  KERNEL_3(a, d, s)
+#define KERNEL_5(s, d, a)   KERNEL_4(s, a, d)  KERNEL_MOVE(5, s, d)  KERNEL_4(a, d, s)
+#define KERNEL_6(s, d, a)   KERNEL_5(s, a, d)  KERNEL_MOVE(6, s, d)  KERNEL_5(a, d, s)
+#define KERNEL_7(s, d, a)   KERNEL_6(s, a, d)  KERNEL_MOVE(7, s, d)  KERNEL_6(a, d, s)
+#define KERNEL_8(s, d, a)   KERNEL_7(s, a, d)  KERNEL_MOVE(8, s, d)  KERNEL_7(a, d, s)
+#define KERNEL_9(s, d, a)   KERNEL_8(s, a, d)  KERNEL_MOVE(9, s, d)  KERNEL_8(a, d, s)
+#define KERNEL_10(s, d, a)  KERNEL_9(s, a, d)  KERNEL_MOVE(10, s, d) KERNEL_9(a, d, s)
+#define KERNEL_11(s, d, a)  KERNEL_10(s, a, d) KERNEL_MOVE(11, s, d) KERNEL_10(a, d, s)
+#define KERNEL_12(s, d, a)  KERNEL_11(s, a, d) KERNEL_MOVE(12, s, d) KERNEL_11(a, d, s)
+#define KERNEL_13(s, d, a)  KERNEL_12(s, a, d) KERNEL_MOVE(13, s, d) KERNEL_12(a, d, s)
+#define KERNEL_14(s, d, a)  KERNEL_13(s, a, d) KERNEL_MOVE(14, s, d) KERNEL_13(a, d, s)
+#define KERNEL_15(s, d, a)  KERNEL_14(s, a, d) KERNEL_MOVE(15, s, d) KERNEL_14(a, d, s)
+#define KERNEL_16(s, d, a)  KERNEL_15(s, a, d) KERNEL_MOVE(16, s, d) KERNEL_15(a, d, s)
+
+static const HanoiPackedMove kernel1[]  = { KERNEL_1(0, 2, 1) };
+static const HanoiPackedMove kernel2[]  = { KERNEL_2(0, 2, 1) };
+static const HanoiPackedMove kernel3[]  = { KERNEL_3(0, 2, 1) };
+static const HanoiPackedMove kernel4[]  = { KERNEL_4(0, 2, 1) };
+static const HanoiPackedMove kernel5[]  = { KERNEL_5(0, 2, 1) };
+static const HanoiPackedMove kernel6[]  = { KERNEL_6(0, 2, 1) };
+static const HanoiPackedMove kernel7[]  = { KERNEL_7(0, 2, 1) };
+static const HanoiPackedMove kernel8[]  = { KERNEL_8(0, 2, 1) };
+static const HanoiPackedMove kernel9[]  = { KERNEL_9(0, 2, 1) };
+static const HanoiPackedMove kernel10[] = { KERNEL_10(0, 2, 1) };
+static const HanoiPackedMove kernel11[] = { KERNEL_11(0, 2, 1) };
+static const HanoiPackedMove kernel12[] = { KERNEL_12(0, 2, 1) };
+static const HanoiPackedMove kernel13[] = { KERNEL_13(0, 2, 1) };
+static const HanoiPackedMove kernel14[] = { KERNEL_14(0, 2, 1) };
+static const HanoiPackedMove kernel15[] = { KERNEL_15(0, 2, 1) };
+static const HanoiPackedMove kernel16[] = { KERNEL_16(0, 2, 1) };
+
+static const HanoiPackedMove *const kernelTables[HANOI_KERNEL_MAX_DISKS + 1] = {
+    NULL, kernel1, kernel2, kernel3, kernel4, kernel5, kernel6, kernel7, kernel8,
+    kernel9, kernel10, kernel11, kernel12, kernel13, kernel14, kernel15, kernel16
+};
+
+// Baked-in solution of n disks (A -> C), or NULL above HANOI_KERNEL_MAX_DISKS
+const HanoiPackedMove *hanoiKernelTable(int n) {
+    return (n >= 1 && n <= HANOI_KERNEL_MAX_DISKS) ? kernelTables[n] : NULL;
+}
+
+// Write the full n-disk solution (2^n - 1 moves) into out: a table copy
+// when a specialised kernel exists, block doubling otherwise
+unsigned long long hanoiSolveInto(int n, HanoiPackedMove *out) {
+    unsigned long long total = (1ULL << n) - 1;
+    const HanoiPackedMove *table = hanoiKernelTable(n);
+    
+    if (table) {
+        memcpy(out, table, total * sizeof(HanoiPackedMove));
+        return total;
+    }
+    return hanoiBlockGenerate(n, out, total, NULL, NULL);
+}
+
+// Dispatcher output must match the closed-form k-th move everywhere
+int hanoiVerifyKernel(int n) {
+    if (n > HANOI_KERNEL_MAX_DISKS) return hanoiVerifyBlockDoubling(n);
+    
+    unsigned long long total = (1ULL << n) - 1;
+    HanoiPackedMove *out = (HanoiPackedMove *)hanoiMalloc(total * sizeof(HanoiPackedMove));
+    if (!out) return 0;
+    
+    int same = hanoiSolveInto(n, out) == total;
+    for (unsigned long long k = 1; same && k <= total; k++) {
+        HanoiMove m = hanoiKthMove(n, k);
+        same = out[k - 1] == HANOI_PACK_MOVE(m.disk, m.from, m.to);
+    }
+    free(out);
+    return same;
+}
+
+THREAD_LOCAL unsigned long long hanoiKernelChecksum;   // keeps benchmark output observable
+
+void hanoiSolveKernel(int n) {
+    size_t mark = hanoiArenaMark();
+    HanoiPackedMove *out = engineChunk();
+    
+    if (!out) return;
+    if (n <= HANOI_KERNEL_MAX_DISKS) {
+        hanoiSolveInto(n, out);
+        hanoiKernelChecksum += out[((1u << n) - 1) / 2];
+    } else {
+        hanoiBlockGenerate(n, out, HANOI_BLOCK_CHUNK_MOVES, blockChecksumFlush, NULL);
+    }
+    engineChunkRelease(out);
+    hanoiArenaRelease(mark);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  SIMD GRAY-CODE GENERATOR
+// ═══════════════════════════════════════════════════════════
+// Move i is made by disk ctz(i) + 1, from peg (i & (i - 1)) % 3; odd disks
+// step +2 and even disks +1 round the pegs, and for even n pegs B and C
+// swap. Nothing depends on the previous move, so a batch of indices is
+// computed lane by lane. Within an aligned 2^16-move block only the low 16
+// bits vary and 2^16 = 1 (mod 3), so a block contributes (i >> 16) % 3 to
+// the source peg and each lane needs 16-bit arithmetic only:
+//   disk   lowest set bit -> de Bruijn multiply -> table lookup
+//   from   (lo & (lo - 1)) % 3 by multiply-high, plus the block's term
+//   pegs   one table lookup on from | parity << 2 gives the low nibble
+// The lane with lo == 0 is a move of a disk above 16 and is patched after.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+#define SIMD_BLOCK_MOVES 65536
+
+int hanoiSimdPath = SIMD_AUTO;
+
+// Indexed by ((lowbit * 0x09AF) & 0xFFFF) >> 12
+static const unsigned char simdDisk[16] = { 1, 2, 3, 6, 4, 10, 7, 12, 16, 5, 9, 11, 15, 8, 14, 13 };
+static const unsigned char simdParity[16] = { 0, 4, 0, 4, 4, 4, 0, 4, 4, 0, 0, 0, 0, 4, 4, 0 };
+
+// Low nibble (from << 2 | to) for each from + 4 * (disk is even)
+static void simdPegTable(int n, unsigned char *lut) {
+    memset(lut, 0, 16);
+    for (int f = 0; f < 3; f++) {
+        for (int even = 0; even < 2; even++) {
+            int t = (f + 2 - even) % 3;
+            int from = (n & 1) ? f : (3 - f) % 3, to = (n & 1) ? t : (3 - t) % 3;
+            lut[f | even << 2] = (unsigned char)(from << 2 | to);
+        }
+    }
+}
+
+static inline HanoiPackedMove simdScalarMove(const unsigned char *lut, unsigned long long i) {
+    int zeros = __builtin_ctzll(i);
+    return (HanoiPackedMove)((zeros + 1) << 4 | lut[(i & (i - 1)) % 3 | (zeros & 1) << 2]);
+}
+
+#ifdef SIMD_X86
+// `vectors` batches of 8 from block offset lo (a multiple of 8); the block
+// adds `carry` to every source peg
+__attribute__((target("sse4.1")))
+static void simdFillSse41(HanoiPackedMove *out, unsigned lo, unsigned carry, size_t vectors, const unsigned char *lut) {
+    const __m128i one = _mm_set1_epi16(1), three = _mm_set1_epi16(3), step = _mm_set1_epi16(8);
+    const __m128i debruijn = _mm_set1_epi16(0x09AF), third = _mm_set1_epi16((short)0xAAAB);
+    const __m128i diskMask = _mm_set1_epi16(0x01F0), pegMask = _mm_set1_epi16(0x000F);
+    const __m128i disks = _mm_loadu_si128((const __m128i *)simdDisk);
+    const __m128i parity = _mm_loadu_si128((const __m128i *)simdParity);
+    const __m128i pegs = _mm_loadu_si128((const __m128i *)lut);
+    const __m128i blockTerm = _mm_set1_epi16((short)carry);
+    __m128i index = _mm_add_epi16(_mm_set1_epi16((short)lo), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (size_t v = 0; v < vectors; v++) {
+        __m128i below = _mm_sub_epi16(index, one);
+        __m128i cleared = _mm_and_si128(index, below);
+        __m128i lowest = _mm_andnot_si128(below, index);
+        __m128i slot = _mm_srli_epi16(_mm_mullo_epi16(lowest, debruijn), 12);
+
+        __m128i q = _mm_srli_epi16(_mm_mulhi_epu16(cleared, third), 1);
+        __m128i from = _mm_add_epi16(_mm_sub_epi16(cleared, _mm_mullo_epi16(q, three)), blockTerm);
+        from = _mm_min_epu16(from, _mm_sub_epi16(from, three));
+
+        __m128i nibble = _mm_shuffle_epi8(pegs, _mm_add_epi16(from, _mm_shuffle_epi8(parity, slot)));
+        __m128i disk = _mm_slli_epi16(_mm_shuffle_epi8(disks, slot), 4);
+        __m128i packed = _mm_or_si128(_mm_and_si128(disk, diskMask), _mm_and_si128(nibble, pegMask));
+        _mm_storeu_si128((__m128i *)(out + v * 8), packed);
+        index = _mm_add_epi16(index, step);
+    }
+}
+
+// Same as above with 16 lanes; the tables are repeated in both 128-bit halves
+__attribute__((target("avx2")))
+static void simdFillAvx2(HanoiPackedMove *out, unsigned lo, unsigned carry, size_t vectors, const unsigned char *lut) {
+    const __m256i one = _mm256_set1_epi16(1), three = _mm256_set1_epi16(3), step = _mm256_set1_epi16(16);
+    const __m256i debruijn = _mm256_set1_epi16(0x09AF), third = _mm256_set1_epi16((short)0xAAAB);
+    const __m256i diskMask = _mm256_set1_epi16(0x01F0), pegMask = _mm256_set1_epi16(0x000F);
+    const __m256i disks = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)simdDisk));
+    const __m256i parity = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)simdParity));
+    const __m256i pegs = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)lut));
+    const __m256i blockTerm = _mm256_set1_epi16((short)carry);
+    __m256i index = _mm256_add_epi16(_mm256_set1_epi16((short)lo),
+                                     _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+    for (size_t v = 0; v < vectors; v++) {
+        __m256i below = _mm256_sub_epi16(index, one);
+        __m256i cleared = _mm256_and_si256(index, below);
+        __m256i lowest = _mm256_andnot_si256(below, index);
+        __m256i slot = _mm256_srli_epi16(_mm256_mullo_epi16(lowest, debruijn), 12);
+
+        __m256i q = _mm256_srli_epi16(_mm256_mulhi_epu16(cleared, third), 1);
+        __m256i from = _mm256_add_epi16(_mm256_sub_epi16(cleared, _mm256_mullo_epi16(q, three)), blockTerm);
+        from = _mm256_min_epu16(from, _mm256_sub_epi16(from, three));
+
+        __m256i nibble = _mm256_shuffle_epi8(pegs, _mm256_add_epi16(from, _mm256_shuffle_epi8(parity, slot)));
+        __m256i disk = _mm256_slli_epi16(_mm256_shuffle_epi8(disks, slot), 4);
+        __m256i packed = _mm256_or_si256(_mm256_and_si256(disk, diskMask), _mm256_and_si256(nibble, pegMask));
+        _mm256_storeu_si256((__m256i *)(out + v * 16), packed);
+        index = _mm256_add_epi16(index, step);
+    }
+}
+#endif
+
+int hanoiSimdPathSupported(int path) {
+    #ifdef SIMD_X86
+    if (path == SIMD_SSE41) return __builtin_cpu_supports("sse4.1");
+    if (path == SIMD_AVX2) return __builtin_cpu_supports("avx2");
+    #endif
+    return path == SIMD_SCALAR;
+}
+
+// The forced path when this CPU has it, otherwise the widest one it has
+int hanoiSimdActivePath() {
+    if (hanoiSimdPath != SIMD_AUTO && hanoiSimdPathSupported(hanoiSimdPath)) return hanoiSimdPath;
+    return hanoiSimdPathSupported(SIMD_AVX2) ? SIMD_AVX2 : hanoiSimdPathSupported(SIMD_SSE41) ? SIMD_SSE41 : SIMD_SCALAR;
+}
+
+const char *hanoiSimdPathName(int path) {
+    return path == SIMD_AVX2 ? "avx2" : path == SIMD_SSE41 ? "sse4.1" : path == SIMD_SCALAR ? "scalar" : "auto";
+}
+
+int hanoiParseSimdPath(const char *text) {
+    for (int path = SIMD_AUTO; path <= SIMD_AVX2; path++) {
+        if (strcmp(text, hanoiSimdPathName(path)) == 0) return path;
+    }
+    return -2;
+}
+
+// Moves first .. first + count - 1 on the given path; vector batches start
+// at multiples of their width and never cross a 2^16 block
+static size_t simdFill(int path, int n, unsigned long long first, HanoiPackedMove *out, size_t count) {
+    unsigned char lut[16];
+    int width = path == SIMD_AVX2 ? 16 : path == SIMD_SSE41 ? 8 : 0;
+
+    if (n < 1 || n > 63 || first < 1 || first > (1ULL << n) - 1) return 0;
+    if (count > (1ULL << n) - first) count = (size_t)((1ULL << n) - first);
+    simdPegTable(n, lut);
+
+    size_t done = 0;
+    while (done < count) {
+        unsigned long long i = first + done;
+        unsigned lo = (unsigned)(i & (SIMD_BLOCK_MOVES - 1));
+        size_t room = count - done < SIMD_BLOCK_MOVES - lo ? count - done : SIMD_BLOCK_MOVES - lo;
+        size_t vectors = width ? room / width : 0;
+
+        if (vectors == 0 || lo % width) {
+            out[done++] = simdScalarMove(lut, i);
+            continue;
+        }
+        #ifdef SIMD_X86
+        if (path == SIMD_AVX2) simdFillAvx2(out + done, lo, (unsigned)((i >> 16) % 3), vectors, lut);
+        else simdFillSse41(out + done, lo, (unsigned)((i >> 16) % 3), vectors, lut);
+        #endif
+        if (lo == 0) out[done] = simdScalarMove(lut, i);
+        done += vectors * width;
+    }
+    return count;
+}
+
+// Moves first .. first + count - 1 (1-based) of the n-disk solution; returns
+// how many were written, fewer when the solution ends first
+size_t hanoiGrayCodeFill(int n, unsigned long long first, HanoiPackedMove *out, size_t count) {
+    return simdFill(hanoiSimdActivePath(), n, first, out, count);
+}
+
+THREAD_LOCAL unsigned long long hanoiSimdChecksum;   // keeps benchmark output observable
+
+void hanoiSolveSimd(int n) {
+    size_t mark = hanoiArenaMark();
+    HanoiPackedMove *out = engineChunk();
+    unsigned long long next = 1;
+    size_t got;
+
+    if (!out) return;
+    while ((got = hanoiGrayCodeFill(n, next, out, HANOI_BLOCK_CHUNK_MOVES)) > 0) {
+        hanoiSimdChecksum += out[got - 1] + got;
+        next += got;
+    }
+    engineChunkRelease(out);
+    hanoiArenaRelease(mark);
+}
+
+// Every path this CPU supports, filled in pieces of varying size so batches
+// start unaligned, must match the closed-form k-th move
+int hanoiVerifySimd(int n) {
+    HanoiPackedMove out[1000];
+
+    for (int path = SIMD_SCALAR; path <= SIMD_AVX2; path++) {
+        if (!hanoiSimdPathSupported(path)) continue;
+
+        unsigned long long k = 0;
+        size_t got, piece = 1;
+        while ((got = simdFill(path, n, k + 1, out, piece)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                HanoiMove m = hanoiKthMove(n, ++k);
+                if (out[i] != HANOI_PACK_MOVE(m.disk, m.from, m.to)) return 0;
+            }
+            piece = piece * 7 % 997 + 1;
+        }
+        if (k != (1ULL << n) - 1) return 0;
+    }
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BATCH-FILL CURSOR
+// ═══════════════════════════════════════════════════════════
+// Disk d always moves the same way round the pegs: +2 (A -> C -> B) when
+// n - d is even, +1 (A -> B -> C) when it is odd, and move k is made by
+// disk ctz(k) + 1. Between two moves of the disks above HANOI_BLOCK_DISKS the
+// small disks replay one relabelled block of the block-doubling tables,
+// so a fill is a few memcpy calls plus one rule step per large-disk move.
+// A fill that stops inside a block rebuilds the small disks' pegs in O(n).
+static const unsigned char cursorStep[2][3] = { { 2, 0, 1 }, { 1, 2, 0 } };
+
+int hanoiCursorInit(HanoiCursor *c, int n) {
+    if (n < 1 || n > HANOI_MAX_DISKS) return 0;
+    c->n = n;
+    c->total = ((HanoiMoveIndex)1 << n) - 1;
+    return hanoiCursorSeek(c, 0);
+}
+
+// Position the cursor after the first `done` moves, O(n)
+int hanoiCursorSeek(HanoiCursor *c, HanoiMoveIndex done) {
+    int pegOf[HANOI_MAX_DISKS + 1];
+    
+    if (done > c->total) return 0;
+    hanoiStateAfter128(c->n, done, pegOf);
+    for (int d = 1; d <= c->n; d++) c->peg[d] = (unsigned char)pegOf[d];
+    c->next = done + 1;
+    return 1;
+}
+
+size_t hanoiCursorFill(HanoiCursor *c, HanoiPackedMove *out, size_t max) {
+    int n = c->n;
+    int k = n < HANOI_BLOCK_DISKS ? n : HANOI_BLOCK_DISKS;
+    int parity = (n - k) & 1;
+    BlockTable *table = hanoiBlockTableFor(k);
+    uint64_t blockMask = (1ULL << k) - 1;
+    HanoiMoveIndex next = c->next;
+    HanoiMoveIndex left = c->total - next + 1;
+    size_t count = left < (HanoiMoveIndex)max ? (size_t)left : max;
+    size_t used = 0;
+    
+    while (used < count) {
+        uint64_t low = (uint64_t)next;
+        size_t r = (size_t)((low - 1) & blockMask);      // moves of the current block already made
+        
+        if (table && r < table->length) {
+            // Disk k stays on the block's source until the block's middle move
+            int src, dst;
+            if (r < (size_t)1 << (k - 1)) {
+                src = c->peg[k];
+                dst = cursorStep[parity][src];
+            } else {
+                dst = c->peg[k];
+                src = cursorStep[parity ^ 1][dst];
+            }
+            size_t run = table->length - r;
+            if (run > count - used) run = count - used;
+            memcpy(out + used, table->copies[permutationIndex(src, dst)] + r, run * sizeof(HanoiPackedMove));
+            used += run;
+            next += run;
+            r += run;
+            
+            if (r == table->length) {
+                memset(c->peg + 1, dst, k);
+            } else {
+                int pegOf[HANOI_BLOCK_DISKS + 1];
+                int label[3] = { src, 3 - src - dst, dst };
+                hanoiStateAfter(k, r, pegOf);
+                for (int d = 1; d <= k; d++) c->peg[d] = (unsigned char)label[pegOf[d]];
+            }
+            continue;
+        }
+        
+        // Single move of a disk above the block
+        int d = low ? __builtin_ctzll(low) + 1 : __builtin_ctzll((uint64_t)(next >> 64)) + 65;
+        int from = c->peg[d];
+        int to = cursorStep[(n - d) & 1][from];
+        c->peg[d] = (unsigned char)to;
+        out[used++] = HANOI_PACK_MOVE(d, from, to);
+        next++;
+    }
+    
+    c->next = next;
+    return count;
+}
+
+THREAD_LOCAL unsigned long long hanoiCursorChecksum;   // keeps benchmark output observable
+
+void hanoiSolveCursor(int n) {
+    HanoiCursor c;
+    size_t mark = hanoiArenaMark();
+    HanoiPackedMove *out = engineChunk();
+    size_t got;
+    
+    if (!out) return;
+    hanoiCursorInit(&c, n);
+    while ((got = hanoiCursorFill(&c, out, HANOI_BLOCK_CHUNK_MOVES)) > 0) hanoiCursorChecksum += out[got - 1] + got;
+    engineChunkRelease(out);
+    hanoiArenaRelease(mark);
+}
+
+// Fills of varying size, so block copies start and stop mid-block, must
+// match the closed-form k-th move
+int hanoiVerifyCursor(int n) {
+    HanoiCursor c;
+    HanoiPackedMove out[1000];
+    unsigned long long k = 0;
+    size_t got, piece = 1;
+    
+    if (!hanoiCursorInit(&c, n)) return 0;
+    while ((got = hanoiCursorFill(&c, out, piece)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            HanoiMove m = hanoiKthMove(n, ++k);
+            if (out[i] != HANOI_PACK_MOVE(m.disk, m.from, m.to)) return 0;
+        }
+        piece = piece * 7 % 997 + 1;
+    }
+    return k == (1ULL << n) - 1;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  GENERAL SOLVER (ANY START -> ANY TARGET)
+// ═══════════════════════════════════════════════════════════
+// Disk d on peg x, with disks d..m gathering on *peg: when d is elsewhere,
+// the smaller disks go to the third peg, d moves and they follow it.
+// Branch-free, since on random configurations the test is a coin flip.
+static inline void towerStep(int x, int d, int *peg, unsigned long long *cost) {
+    int moved = x != *peg;
+    *cost += (unsigned long long)moved << (d - 1);
+    *peg = moved ? 3 - x - *peg : *peg;
+}
+
+// Moves needed to gather disks 1..m of a configuration into a tower on `peg`
+unsigned long long hanoiTowerDistance(int m, const int *pegOf, int peg) {
+    unsigned long long cost = 0;
+    for (int d = m; d >= 1; d--) towerStep(pegOf[d], d, &peg, &cost);
+    return cost;
+}
+
+// Largest disk that differs between the configurations, or 0 when equal
+static int largestMismatch(int n, const int *start, const int *target) {
+    for (int d = n; d >= 1; d--) {
+        if (start[d] != target[d]) return d;
+    }
+    return 0;
+}
+
+// Length of the direct route (largest mismatched disk d moves once, the
+// smaller disks wait on the third peg) and of the two-step route (disk d
+// goes through the third peg). The shortest path is always one of them.
+static void hanoiRouteLengths(const int *start, const int *target, int d,
+                       unsigned long long *direct, unsigned long long *twoStep) {
+    int p = start[d], q = target[d], r = 3 - p - q;
+    int startR = r, targetR = r, startQ = q, targetP = p;
+    unsigned long long costStartR = 0, costTargetR = 0, costStartQ = 0, costTargetP = 0;
+    
+    // The four tower distances in one pass
+    for (int k = d - 1; k >= 1; k--) {
+        towerStep(start[k], k, &startR, &costStartR);
+        towerStep(target[k], k, &targetR, &costTargetR);
+        towerStep(start[k], k, &startQ, &costStartQ);
+        towerStep(target[k], k, &targetP, &costTargetP);
+    }
+    *direct = costStartR + 1 + costTargetR;
+    *twoStep = costStartQ + 1 + ((1ULL << (d - 1)) - 1) + 1 + costTargetP;
+}
+
+// Minimum number of moves between two legal configurations, O(n)
+unsigned long long hanoiDistance(int n, const int *start, const int *target) {
+    int d = largestMismatch(n, start, target);
+    if (d == 0) return 0;
+    
+    unsigned long long direct, twoStep;
+    hanoiRouteLengths(start, target, d, &direct, &twoStep);
+    return direct <= twoStep ? direct : twoStep;
+}
+
+static void emitMove(HanoiMoveEmitter emit, void *ctx, int disk, int from, int to) {
+    HanoiMove m;
+    m.disk = disk;
+    m.from = from;
+    m.to = to;
+    emit(&m, ctx);
+}
+
+// Whole tower of disks 1..m from `from` to `to`, relabelling the canonical
+// A -> C sequence produced by hanoiKthMove
+static void emitTower(int m, int from, int to, HanoiMoveEmitter emit, void *ctx) {
+    if (m == 0) return;
+    int label[3];
+    label[0] = from;
+    label[1] = 3 - from - to;
+    label[2] = to;
+    
+    unsigned long long total = (1ULL << m) - 1;
+    for (unsigned long long k = 1; k <= total; k++) {
+        HanoiMove c = hanoiKthMove(m, k);
+        emitMove(emit, ctx, c.disk, label[c.from], label[c.to]);
+    }
+}
+
+// Disks 1..m of pegOf gathered into a tower on `peg`
+static void emitGather(int m, const int *pegOf, int peg, HanoiMoveEmitter emit, void *ctx) {
+    int goal[64];
+    
+    // goal[d] is where disks 1..d must be stacked before disk d+1 is handled
+    for (int d = m; d >= 1; d--) {
+        goal[d] = peg;
+        if (pegOf[d] != peg) peg = 3 - pegOf[d] - peg;
+    }
+    
+    for (int d = 1; d <= m; d++) {
+        if (pegOf[d] != goal[d]) {
+            int parked = 3 - pegOf[d] - goal[d];
+            emitMove(emit, ctx, d, pegOf[d], goal[d]);
+            emitTower(d - 1, parked, goal[d], emit, ctx);
+        }
+    }
+}
+
+// Tower of disks 1..m on `peg` spread out into configuration pegOf
+static void emitSpread(int m, const int *pegOf, int peg, HanoiMoveEmitter emit, void *ctx) {
+    for (int d = m; d >= 1; d--) {
+        if (pegOf[d] != peg) {
+            int parked = 3 - pegOf[d] - peg;
+            emitTower(d - 1, peg, parked, emit, ctx);
+            emitMove(emit, ctx, d, peg, pegOf[d]);
+            peg = parked;
+        }
+    }
+}
+
+// Shortest move sequence from `start` to `target` (pegOf[1..n], n <= 63).
+// The length is known in O(n) before any move is produced; moves are
+// streamed to `emit` one by one (pass NULL to only get the length).
+unsigned long long hanoiSolveBetween(int n, const int *start, const int *target,
+                                     HanoiMoveEmitter emit, void *ctx) {
+    int d = largestMismatch(n, start, target);
+    if (d == 0) return 0;
+    
+    unsigned long long direct, twoStep;
+    hanoiRouteLengths(start, target, d, &direct, &twoStep);
+    if (!emit) return direct <= twoStep ? direct : twoStep;
+    
+    int p = start[d], q = target[d], r = 3 - p - q;
+    if (direct <= twoStep) {
+        emitGather(d - 1, start, r, emit, ctx);
+        emitMove(emit, ctx, d, p, q);
+        emitSpread(d - 1, target, r, emit, ctx);
+        return direct;
+    }
+    
+    emitGather(d - 1, start, q, emit, ctx);
+    emitMove(emit, ctx, d, p, r);
+    emitTower(d - 1, q, p, emit, ctx);
+    emitMove(emit, ctx, d, r, q);
+    emitSpread(d - 1, target, p, emit, ctx);
+    return twoStep;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  DISTANCE ORACLE
+// ═══════════════════════════════════════════════════════════
+// Input is read HANOI_ORACLE_BLOCK_BYTES at a time and cut after its last full
+// line. Each thread takes an equal byte range of the block and owns the
+// lines that start in it; it parses, answers and formats them into its own
+// output buffer, and the buffers are written in thread order.
+typedef struct {
+    char *out;
+    size_t used;
+    size_t capacity;
+    unsigned long long lines;         // input lines seen, blank ones included
+    unsigned long long queries;
+    unsigned long long invalid;
+    unsigned long long firstInvalid;  // 1-based line within the slice, 0 = none
+    int failed;                       // out of memory
+} OracleSlice;
+
+typedef struct {
+    const char *text;
+    size_t length;
+    int threads;
+    int json;
+    OracleSlice *slices;
+} OracleRound;
+
+static int oracleSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',';
+}
+
+static const char *oracleSkip(const char *s, const char *end, int cr) {
+    while (s < end && (oracleSeparator(*s) || (cr && *s == '\r'))) s++;
+    return s;
+}
+
+// One configuration token into pegOf[1..n]; returns n, 0 when malformed
+static int oracleConfig(const char **p, const char *end, int *pegOf) {
+    const char *s = *p;
+    int n = 0;
+    for (; s < end && !oracleSeparator(*s) && *s != '\r'; s++) {
+        unsigned peg = (unsigned)((*s | 0x20) - 'a');    // either case
+        if (peg > 2 || n == HANOI_ORACLE_MAX_DISKS) return 0;
+        pegOf[++n] = (int)peg;
+    }
+    *p = s;
+    return n;
+}
+
+// Distance of one "START TARGET" line (without its newline)
+unsigned long long hanoiDistanceQuery(const char *line, const char *end) {
+    int start[HANOI_ORACLE_MAX_DISKS + 1], target[HANOI_ORACLE_MAX_DISKS + 1];
+    
+    line = oracleSkip(line, end, 0);
+    int n = oracleConfig(&line, end, start);
+    if (n == 0 || line == end || !oracleSeparator(*line)) return HANOI_ORACLE_INVALID;
+    line = oracleSkip(line, end, 0);
+    if (oracleConfig(&line, end, target) != n) return HANOI_ORACLE_INVALID;
+    return oracleSkip(line, end, 1) == end ? hanoiDistance(n, start, target) : HANOI_ORACLE_INVALID;
+}
+
+static int oracleReserve(OracleSlice *s, size_t more) {
+    if (s->used + more <= s->capacity) return 1;
+    size_t capacity = s->capacity ? s->capacity * 2 : 1 << 16;
+    while (capacity < s->used + more) capacity *= 2;
+    char *out = (char *)hanoiRealloc(s->out, capacity);
+    if (!out) return 0;
+    s->out = out;
+    s->capacity = capacity;
+    return 1;
+}
+
+static char *oracleNumber(char *p, unsigned long long v) {
+    char digits[20];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (len) *p++ = digits[--len];
+    return p;
+}
+
+static void oracleWorker(int id, void *ctx) {
+    OracleRound *r = (OracleRound *)ctx;
+    OracleSlice *s = &r->slices[id];
+    const char *text = r->text, *end = text + r->length;
+    const char *p = text + r->length * id / r->threads;
+    const char *stop = text + r->length * (id + 1) / r->threads;
+    
+    // Lines that start before our range belong to the previous thread
+    if (p > text && p[-1] != '\n') {
+        p = (const char *)memchr(p, '\n', (size_t)(end - p));
+        p = p ? p + 1 : end;
+    }
+    
+    s->used = s->lines = s->queries = s->invalid = s->firstInvalid = 0;
+    s->failed = 0;
+    while (p < stop) {
+        const char *eol = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        s->lines++;
+        
+        if (oracleSkip(p, eol, 1) < eol) {
+            unsigned long long d = hanoiDistanceQuery(p, eol);
+            if (!oracleReserve(s, 48)) {
+                s->failed = 1;
+                return;
+            }
+            char *o = s->out + s->used;
+            if (r->json) {
+                memcpy(o, "{\"distance\":", 12);
+                o += 12;
+                if (d == HANOI_ORACLE_INVALID) {
+                    memcpy(o, "null", 4);
+                    o += 4;
+                } else {
+                    o = oracleNumber(o, d);
+                }
+                *o++ = '}';
+            } else if (d != HANOI_ORACLE_INVALID) {
+                o = oracleNumber(o, d);
+            }
+            *o++ = '\n';
+            s->used = (size_t)(o - s->out);
+            
+            s->queries++;
+            if (d == HANOI_ORACLE_INVALID && s->invalid++ == 0) s->firstInvalid = s->lines;
+        }
+        p = eol + 1;
+    }
+}
+
+// Answer every query of `in` on `out` (csv with a header, or json lines).
+// Returns 0 on a read or write error or when out of memory.
+int hanoiDistanceOracle(FILE *in, FILE *out, int threads, int json, HanoiOracleStats *stats) {
+    OracleSlice slices[HANOI_MAX_THREADS];
+    OracleRound round;
+    unsigned long long lineBase = 0;
+    size_t carry = 0;
+    int ok = 1;
+    
+    if (threads < 1) threads = 1;
+    if (threads > HANOI_MAX_THREADS) threads = HANOI_MAX_THREADS;
+    memset(stats, 0, sizeof(*stats));
+    memset(slices, 0, sizeof(slices));
+    stats->threads = threads;
+    
+    char *buffer = (char *)hanoiMalloc(HANOI_ORACLE_BLOCK_BYTES + 1);
+    if (!buffer) return 0;
+    if (!json) fputs("distance\n", out);
+    
+    round.text = buffer;
+    round.threads = threads;
+    round.json = json;
+    round.slices = slices;
+    
+    for (;;) {
+        size_t got = fread(buffer + carry, 1, HANOI_ORACLE_BLOCK_BYTES - carry, in);
+        size_t have = carry + got;
+        int last = got < HANOI_ORACLE_BLOCK_BYTES - carry;
+        if (last && ferror(in)) ok = 0;
+        if (have == 0) break;
+        
+        // Cut after the last newline; at the end, terminate the last line.
+        // A line longer than the whole block is cut and shows up as invalid.
+        size_t cut = have;
+        if (last) {
+            if (buffer[have - 1] != '\n') buffer[have++] = '\n';
+            cut = have;
+        } else {
+            while (cut > 0 && buffer[cut - 1] != '\n') cut--;
+            if (cut == 0) cut = have;
+        }
+        
+        round.length = cut;
+        hanoiParallelRun(threads, oracleWorker, &round);
+        
+        for (int t = 0; t < threads; t++) {
+            OracleSlice *s = &slices[t];
+            if (s->failed || fwrite(s->out, 1, s->used, out) != s->used) ok = 0;
+            if (s->invalid && !stats->firstInvalid) stats->firstInvalid = lineBase + s->firstInvalid;
+            stats->queries += s->queries;
+            stats->invalid += s->invalid;
+            lineBase += s->lines;
+        }
+        
+        carry = have - cut;
+        memmove(buffer, buffer + cut, carry);
+        if (!ok || (last && carry == 0)) break;
+    }
+    
+    for (int t = 0; t < threads; t++) free(slices[t].out);
+    free(buffer);
+    return ok && fflush(out) == 0;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  MULTI-PEG (FRAME-STEWART) IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════
+// Frame-Stewart: move the top k disks to a spare peg using all p pegs, the
+// remaining n-k disks to the destination using p-1 pegs, then the k disks
+// on top of them. The best k for every (disks, pegs) pair is memoised once.
+#define MOVE_CHUNK    4096
+
+static unsigned long long fsMoves[HANOI_FS_MAX_DISKS + 1][HANOI_FS_MAX_PEGS + 1];
+static int fsSplit[HANOI_FS_MAX_DISKS + 1][HANOI_FS_MAX_PEGS + 1];
+static int fsReady = 0;
+static int fsLock = 0;
+int hanoiFrameStewartPegs = 4;   // peg count used by the framestewart engine
+
+static unsigned long long addSaturated(unsigned long long a, unsigned long long b) {
+    return (a > HANOI_FS_SATURATED - b) ? HANOI_FS_SATURATED : a + b;
+}
+
+static void fsBuild() {
+    for (int p = 0; p <= HANOI_FS_MAX_PEGS; p++) {
+        fsMoves[0][p] = 0;
+        fsMoves[1][p] = 1;
+        fsSplit[1][p] = 0;
+    }
+    for (int n = 2; n <= HANOI_FS_MAX_DISKS; n++) {
+        fsMoves[n][2] = HANOI_FS_SATURATED;      // impossible with two pegs
+        fsMoves[n][3] = (n < 64) ? (1ULL << n) - 1 : HANOI_FS_SATURATED;
+        fsSplit[n][3] = n - 1;
+        
+        for (int p = 4; p <= HANOI_FS_MAX_PEGS; p++) {
+            fsMoves[n][p] = HANOI_FS_SATURATED;
+            for (int k = 1; k < n; k++) {
+                unsigned long long top = fsMoves[k][p];
+                unsigned long long cost = addSaturated(addSaturated(top, top), fsMoves[n - k][p - 1]);
+                if (cost < fsMoves[n][p]) {
+                    fsMoves[n][p] = cost;
+                    fsSplit[n][p] = k;
+                }
+            }
+        }
+    }
+}
+
+// Same publication as hanoiBlockTableFor: built once under a spin lock,
+// published by the release store of fsReady
+void hanoiFrameStewartInit() {
+    if (__atomic_load_n(&fsReady, __ATOMIC_ACQUIRE)) return;
+    
+    while (__atomic_exchange_n(&fsLock, 1, __ATOMIC_ACQUIRE)) hanoiSleepMs(0);
+    if (!fsReady) {
+        fsBuild();
+        __atomic_store_n(&fsReady, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&fsLock, 0, __ATOMIC_RELEASE);
+}
+
+// Frame-Stewart move count for any n, without the table: with T the largest
+// integer such that C(T+p-3, p-2) <= n,
+//   FS(n, p) = sum_{t<T} 2^t C(t+p-3, p-3) + 2^T (n - C(T+p-3, p-2))
+// Returns HANOI_FS_SATURATED when the count does not fit in 64 bits.
+unsigned long long hanoiFrameStewartCount(unsigned long long n, int p) {
+    if (p < HANOI_FS_MIN_PEGS || p > HANOI_FS_MAX_PEGS) return HANOI_FS_SATURATED;
+    if (n == 0) return 0;
+    
+    unsigned long long total = 0;
+    unsigned long long used = 0;          // C(t+p-3, p-2): disks covered by levels < t
+    for (int t = 0; ; t++) {
+        // binom = C(t+p-3, p-3): number of disks moved 2^t times
+        unsigned long long binom = 1;
+        for (int i = 1; i <= p - 3; i++) binom = binom * (t + i) / i;
+        
+        if (t >= 64) return HANOI_FS_SATURATED;
+        unsigned long long weight = 1ULL << t;
+        if (used + binom > n) {
+            unsigned long long rest = n - used;
+            if (rest > HANOI_FS_SATURATED / weight) return HANOI_FS_SATURATED;
+            return addSaturated(total, rest * weight);
+        }
+        if (binom > HANOI_FS_SATURATED / weight) return HANOI_FS_SATURATED;
+        total = addSaturated(total, binom * weight);
+        if (total == HANOI_FS_SATURATED) return HANOI_FS_SATURATED;
+        used += binom;
+    }
+}
+
+// Disks moved to the spare peg first in the memoised optimum; 0 when n or p
+// is out of range
+int hanoiFrameStewartSplit(int n, int p) {
+    if (n < 0 || n > HANOI_FS_MAX_DISKS || p < HANOI_FS_MIN_PEGS || p > HANOI_FS_MAX_PEGS) return 0;
+    hanoiFrameStewartInit();
+    return fsSplit[n][p];
+}
+
+typedef struct {
+    HanoiMove moves[MOVE_CHUNK];
+    int used;
+    unsigned long long total;
+    void (*flush)(const HanoiMove *moves, int count, void *ctx);
+    void *ctx;
+} MoveChunk;
+
+static void moveChunkFlush(MoveChunk *c) {
+    if (c->used && c->flush) c->flush(c->moves, c->used, c->ctx);
+    c->total += c->used;
+    c->used = 0;
+}
+
+#define MOVE_CHUNK_PUSH(c, d, f, t) do {                                  \
+        HanoiMove *slot_ = &(c)->moves[(c)->used];                             \
+        slot_->disk = (d); slot_->from = (f); slot_->to = (t);            \
+        if (++(c)->used == MOVE_CHUNK) moveChunkFlush(c);                 \
+    } while (0)
+
+// Classic three-peg recursion for disks base+1 .. base+n
+static void fsThreePeg(int n, int base, int src, int dst, int aux, MoveChunk *out) {
+    if (n == 0) return;
+    fsThreePeg(n - 1, base, src, aux, dst, out);
+    MOVE_CHUNK_PUSH(out, base + n, src, dst);
+    fsThreePeg(n - 1, base, aux, dst, src, out);
+}
+
+// Move disks base+1 .. base+n from pegs[0] to pegs[p-1] using the p pegs listed
+static void fsSolve(int n, int base, const int *pegs, int p, MoveChunk *out) {
+    if (n == 0) return;
+    if (n == 1) {
+        MOVE_CHUNK_PUSH(out, base + 1, pegs[0], pegs[p - 1]);
+        return;
+    }
+    if (p == 3) {
+        fsThreePeg(n, base, pegs[0], pegs[2], pegs[1], out);
+        return;
+    }
+    
+    int k = fsSplit[n][p];
+    int park = pegs[1];
+    int toPark[HANOI_FS_MAX_PEGS], rest[HANOI_FS_MAX_PEGS], fromPark[HANOI_FS_MAX_PEGS];
+    
+    // Top k disks: src -> park with every peg available
+    toPark[0] = pegs[0];
+    for (int i = 2; i < p; i++) toPark[i - 1] = pegs[i];
+    toPark[p - 1] = park;
+    fsSolve(k, base, toPark, p, out);
+    
+    // Bottom n-k disks: src -> dst without the park peg
+    rest[0] = pegs[0];
+    for (int i = 2; i < p; i++) rest[i - 1] = pegs[i];
+    fsSolve(n - k, base + k, rest, p - 1, out);
+    
+    // Top k disks: park -> dst
+    fromPark[0] = park;
+    fromPark[1] = pegs[0];
+    for (int i = 2; i < p; i++) fromPark[i] = pegs[i];
+    fsSolve(k, base, fromPark, p, out);
+}
+
+// Stream the Frame-Stewart solution of n disks on p pegs (peg 0 -> peg p-1)
+// in chunks of MOVE_CHUNK moves. Returns the number of moves produced, 0
+// when n or p is out of range.
+unsigned long long hanoiFrameStewartStream(int n, int p, void (*flush)(const HanoiMove *, int, void *), void *ctx) {
+    int pegs[HANOI_FS_MAX_PEGS];
+    if (n < 0 || n > HANOI_FS_MAX_DISKS || p < HANOI_FS_MIN_PEGS || p > HANOI_FS_MAX_PEGS) return 0;
+    
+    size_t mark = hanoiArenaMark();
+    MoveChunk *out = hanoiThreadArena ? (MoveChunk *)hanoiArenaAlloc(hanoiThreadArena, sizeof(MoveChunk)) : NULL;
+    if (!out) out = (MoveChunk *)hanoiMalloc(sizeof(MoveChunk));
+    if (!out) return 0;
+    
+    hanoiFrameStewartInit();
+    for (int i = 0; i < p; i++) pegs[i] = i;
+    out->used = 0;
+    out->total = 0;
+    out->flush = flush;
+    out->ctx = ctx;
+    
+    fsSolve(n, 0, pegs, p, out);
+    moveChunkFlush(out);
+    
+    unsigned long long total = out->total;
+    if (!hanoiArenaOwns(out)) free(out);
+    hanoiArenaRelease(mark);
+    return total;
+}
+
+THREAD_LOCAL unsigned long long hanoiFsChecksum;   // keeps benchmark output observable
+
+static void fsChecksumFlush(const HanoiMove *moves, int count, void *ctx) {
+    (void)ctx;
+    hanoiFsChecksum += (unsigned long long)count * moves[count - 1].disk;
+}
+
+void hanoiSolveFrameStewart(int n) {
+    hanoiFrameStewartStream(n, hanoiFrameStewartPegs, fsChecksumFlush, NULL);
+}
+
+unsigned long long hanoiFrameStewartEngineMoves(int n) {
+    hanoiFrameStewartInit();
+    return fsMoves[n][hanoiFrameStewartPegs];
+}
+
+typedef struct {
+    uint64_t peg[HANOI_FS_MAX_PEGS];
+    int legal;
+} FsReplay;
+
+static void fsReplayFlush(const HanoiMove *moves, int count, void *ctx) {
+    FsReplay *r = (FsReplay *)ctx;
+    for (int i = 0; i < count; i++) {
+        uint64_t bit = 1ULL << (moves[i].disk - 1);
+        uint64_t *from = &r->peg[moves[i].from];
+        uint64_t *to = &r->peg[moves[i].to];
+        // The disk must be on top of its peg and smaller than the target's top
+        if (!(*from & bit) || (*from & (bit - 1)) || (*to & (bit - 1))) r->legal = 0;
+        *from &= ~bit;
+        *to |= bit;
+    }
+}
+
+// Replay the stream on bitboards: every move legal, all disks end on the
+// last peg, and the length matches the memoised count
+int hanoiVerifyFrameStewart(int n) {
+    FsReplay replay;
+    int p = hanoiFrameStewartPegs;
+    
+    memset(&replay, 0, sizeof(replay));
+    replay.peg[0] = (n < 64) ? (1ULL << n) - 1 : ~0ULL;
+    replay.legal = 1;
+    
+    unsigned long long moves = hanoiFrameStewartStream(n, p, fsReplayFlush, &replay);
+    return replay.legal && moves == hanoiFrameStewartEngineMoves(n) && replay.peg[p - 1] == ((n < 64) ? (1ULL << n) - 1 : ~0ULL);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  RESTRICTED VARIANTS (ADJACENT-PEG, CYCLIC)
+// ═══════════════════════════════════════════════════════════
+// Adjacent-peg: move k is made by disk v3(k) + 1 (v3 = number of trailing
+// zeros in base 3), and every disk sweeps A -> B -> C -> B -> A -> ...
+// starting from A, so the stream is a base-3 counter plus a 2-bit sweep
+// phase per disk, and the k-th move is closed-form.
+// Cyclic: no such rule is known, so the stream runs the recursion on an
+// explicit stack of n frames; the k-th move descends it once, O(n).
+// Both streams copy pre-generated blocks for the smallest disks.
+static const unsigned char adjacentSweep[5] = { 0, 1, 2, 1, 0 };
+
+// Items of a cyclic frame, with pegs relative to the frame's source:
+//   Q:  R(m-1) at +0, move m +0 -> +1, R(m-1) at +2
+//   R:  R(m-1) at +0, move m +0 -> +1, Q(m-1) at +2, move m +1 -> +2, R(m-1) at +0
+#define CYCLIC_SUB_Q  0
+#define CYCLIC_SUB_R  1
+#define CYCLIC_MOVE   2
+#define CYCLIC_END    3
+
+typedef struct {
+    unsigned char op, a, b;
+} CyclicItem;
+
+static const CyclicItem cyclicScript[2][6] = {
+    { { CYCLIC_SUB_R, 0, 0 }, { CYCLIC_MOVE, 0, 1 }, { CYCLIC_SUB_R, 2, 0 }, { CYCLIC_END, 0, 0 } },
+    { { CYCLIC_SUB_R, 0, 0 }, { CYCLIC_MOVE, 0, 1 }, { CYCLIC_SUB_Q, 2, 0 },
+      { CYCLIC_MOVE, 1, 2 }, { CYCLIC_SUB_R, 0, 0 }, { CYCLIC_END, 0, 0 } },
+};
+
+// count[0][m] = Q(m), count[1][m] = R(m) for m = 0..n
+static void cyclicCounts(int n, HanoiMoveIndex count[2][HANOI_VARIANT_MAX_DISKS + 1]) {
+    count[0][0] = count[1][0] = 0;
+    for (int m = 1; m <= n; m++) {
+        count[0][m] = 2 * count[1][m - 1] + 1;
+        count[1][m] = 2 * count[1][m - 1] + count[0][m - 1] + 2;
+    }
+}
+
+int hanoiVariantMaxDisks(int variant) {
+    return variant == HANOI_VARIANT_ADJACENT ? HANOI_ADJACENT_MAX_DISKS : variant == HANOI_VARIANT_CYCLIC ? HANOI_CYCLIC_MAX_DISKS : 0;
+}
+
+const char *hanoiVariantName(int variant) {
+    return variant == HANOI_VARIANT_ADJACENT ? "adjacent" : variant == HANOI_VARIANT_CYCLIC ? "cyclic" : "classic";
+}
+
+int hanoiParseVariant(const char *text) {
+    if (strcmp(text, "adjacent") == 0) return HANOI_VARIANT_ADJACENT;
+    if (strcmp(text, "cyclic") == 0) return HANOI_VARIANT_CYCLIC;
+    return -1;
+}
+
+HanoiMoveIndex hanoiVariantMoveCount(int variant, int n) {
+    if (n < 1 || n > hanoiVariantMaxDisks(variant)) return 0;
+    if (variant == HANOI_VARIANT_ADJACENT) {
+        HanoiMoveIndex power = 1;
+        for (int d = 0; d < n; d++) power *= 3;
+        return power - 1;
+    }
+    
+    HanoiMoveIndex count[2][HANOI_VARIANT_MAX_DISKS + 1];
+    cyclicCounts(n, count);
+    return count[1][n];
+}
+
+// Move k of the adjacent-peg solution: disk d = v3(k) + 1 has made
+// r - r / 3 - 1 moves before it, where r = k / 3^(d - 1)
+static HanoiMove adjacentKthMove(HanoiMoveIndex k) {
+    HanoiMove m;
+    m.disk = 1;
+    while (k % 3 == 0) {
+        k /= 3;
+        m.disk++;
+    }
+    int phase = (int)((k - k / 3 - 1) & 3);
+    m.from = adjacentSweep[phase];
+    m.to = adjacentSweep[phase + 1];
+    return m;
+}
+
+// Move k (1-based) of the variant's solution; disk 0 when k is out of range
+HanoiMove hanoiVariantKthMove(int variant, int n, HanoiMoveIndex k) {
+    HanoiMove m = { 0, 0, 0 };
+    HanoiVariantStream s;
+    HanoiPackedMove packed;
+    
+    if (k < 1 || k > hanoiVariantMoveCount(variant, n)) return m;
+    if (variant == HANOI_VARIANT_ADJACENT) return adjacentKthMove(k);
+    
+    hanoiVariantStreamInit(&s, variant, n);
+    hanoiVariantStreamSeek(&s, k - 1);
+    hanoiVariantStreamFill(&s, &packed, 1);
+    m.disk = HANOI_PACKED_DISK(packed);
+    m.from = HANOI_PACKED_FROM(packed);
+    m.to = HANOI_PACKED_TO(packed);
+    return m;
+}
+
+int hanoiVariantStreamInit(HanoiVariantStream *s, int variant, int n) {
+    if (n < 1 || n > hanoiVariantMaxDisks(variant)) return 0;
+    s->variant = variant;
+    s->n = n;
+    s->total = hanoiVariantMoveCount(variant, n);
+    return hanoiVariantStreamSeek(s, 0);
+}
+
+// Position the stream after the first `done` moves, O(n)
+int hanoiVariantStreamSeek(HanoiVariantStream *s, HanoiMoveIndex done) {
+    if (done > s->total) return 0;
+    s->next = done + 1;
+    
+    if (s->variant == HANOI_VARIANT_ADJACENT) {
+        // Disk d has moved done / 3^(d-1) - done / 3^d times
+        HanoiMoveIndex rest = done;
+        for (int d = 1; d <= s->n; d++) {
+            HanoiMoveIndex above = rest / 3;
+            s->digit[d - 1] = (unsigned char)(rest - above * 3);
+            s->phase[d] = (unsigned char)((rest - above) & 3);
+            rest = above;
+        }
+        return 1;
+    }
+    
+    // Cyclic: descend from the whole solve, entering the sub-solve that
+    // holds move done + 1 and skipping the ones before it
+    HanoiMoveIndex count[2][HANOI_VARIANT_MAX_DISKS + 1];
+    cyclicCounts(s->n, count);
+    s->depth = 0;
+    if (done == s->total) return 1;
+    
+    HanoiVariantFrame top = { (unsigned char)s->n, 1, 0, 0 };
+    s->frame[s->depth++] = top;
+    for (;;) {
+        HanoiVariantFrame *f = &s->frame[s->depth - 1];
+        const CyclicItem *item = &cyclicScript[f->kind][f->step];
+        
+        if (item->op == CYCLIC_MOVE) {
+            if (done == 0) return 1;
+            done--;
+            f->step++;
+            continue;
+        }
+        
+        HanoiMoveIndex size = count[item->op][f->disks - 1];
+        f->step++;
+        if (done < size) {
+            HanoiVariantFrame sub = { (unsigned char)(f->disks - 1), item->op, (unsigned char)((f->src + item->a) % 3), 0 };
+            s->frame[s->depth++] = sub;
+        } else {
+            done -= size;
+        }
+    }
+}
+
+// Leaf blocks: every sub-solve of at most VARIANT_LEAF_DISKS disks is
+// generated once and then copied. Adjacent-peg fills copy the whole
+// L-disk solve between two moves of larger disks, A -> C or mirrored
+// C -> A; cyclic fills copy the small frames of the recursion.
+#define VARIANT_LEAF_DISKS 8
+
+typedef struct {
+    size_t adjacentLength;                                   // 3^L - 1
+    HanoiPackedMove *adjacent[2];                            // from A, from C
+    size_t cyclicLength[2][VARIANT_LEAF_DISKS + 1];          // [kind][disks]
+    HanoiPackedMove *cyclic[2][VARIANT_LEAF_DISKS + 1][3];   // [kind][disks][source peg]
+} VariantLeaves;
+
+static VariantLeaves variantLeaves;
+static int variantLeavesReady = 0;
+static int variantLeavesLock = 0;
+
+static HanoiPackedMove *cyclicEmit(int m, int kind, int src, HanoiPackedMove *out) {
+    const CyclicItem *item = cyclicScript[kind];
+    
+    for (; item->op != CYCLIC_END; item++) {
+        if (item->op == CYCLIC_MOVE) *out++ = HANOI_PACK_MOVE(m, (src + item->a) % 3, (src + item->b) % 3);
+        else if (m > 1) out = cyclicEmit(m - 1, item->op, (src + item->a) % 3, out);
+    }
+    return out;
+}
+
+static int variantLeavesBuild(VariantLeaves *leaves) {
+    HanoiMoveIndex count[2][HANOI_VARIANT_MAX_DISKS + 1];
+    size_t length = (size_t)hanoiVariantMoveCount(HANOI_VARIANT_ADJACENT, VARIANT_LEAF_DISKS);
+    
+    for (int dir = 0; dir < 2; dir++) {
+        HanoiPackedMove *block = (HanoiPackedMove *)hanoiMalloc(length * sizeof(HanoiPackedMove));
+        if (!block) return 0;
+        for (size_t k = 1; k <= length; k++) {
+            HanoiMove m = adjacentKthMove(k);
+            block[k - 1] = dir ? HANOI_PACK_MOVE(m.disk, 2 - m.from, 2 - m.to) : HANOI_PACK_MOVE(m.disk, m.from, m.to);
+        }
+        leaves->adjacent[dir] = block;
+    }
+    leaves->adjacentLength = length;
+    
+    cyclicCounts(VARIANT_LEAF_DISKS, count);
+    for (int kind = 0; kind < 2; kind++) {
+        for (int m = 1; m <= VARIANT_LEAF_DISKS; m++) {
+            leaves->cyclicLength[kind][m] = (size_t)count[kind][m];
+            for (int src = 0; src < 3; src++) {
+                HanoiPackedMove *block = (HanoiPackedMove *)hanoiMalloc(leaves->cyclicLength[kind][m] * sizeof(HanoiPackedMove));
+                if (!block) return 0;
+                cyclicEmit(m, kind, src, block);
+                leaves->cyclic[kind][m][src] = block;
+            }
+        }
+    }
+    return 1;
+}
+
+// Built on first use under a spin lock, like the block tables; NULL when
+// out of memory, and the fills then step every move
+static const VariantLeaves *variantLeavesGet() {
+    if (__atomic_load_n(&variantLeavesReady, __ATOMIC_ACQUIRE)) return &variantLeaves;
+    
+    while (__atomic_exchange_n(&variantLeavesLock, 1, __ATOMIC_ACQUIRE)) hanoiSleepMs(0);
+    if (!variantLeavesReady && variantLeavesBuild(&variantLeaves)) {
+        __atomic_store_n(&variantLeavesReady, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&variantLeavesLock, 0, __ATOMIC_RELEASE);
+    return variantLeavesReady ? &variantLeaves : NULL;
+}
+
+static size_t adjacentFill(HanoiVariantStream *s, HanoiPackedMove *out, size_t max) {
+    const VariantLeaves *leaves = s->n >= VARIANT_LEAF_DISKS ? variantLeavesGet() : NULL;
+    unsigned char *digit = s->digit, *phase = s->phase;
+    size_t count = 0;
+    
+    // Blocks done so far = the digits above the low L; its parity says
+    // whether the small disks set off from A or from C in this block
+    int odd = 0;
+    for (int d = VARIANT_LEAF_DISKS; leaves && d < s->n; d++) odd ^= digit[d] & 1;
+    
+    while (count < max) {
+        size_t r = 0;
+        for (int d = VARIANT_LEAF_DISKS - 1; leaves && d >= 0; d--) r = r * 3 + digit[d];
+        
+        if (leaves && r < leaves->adjacentLength) {
+            // Copy the rest of the block (or what fits), then rebuild the
+            // small disks' digits and phases from the new offset
+            size_t take = leaves->adjacentLength - r < max - count ? leaves->adjacentLength - r : max - count;
+            memcpy(out + count, leaves->adjacent[odd] + r, take * sizeof(HanoiPackedMove));
+            count += take;
+            r += take;
+            for (int d = 1; d <= VARIANT_LEAF_DISKS; d++) {
+                size_t above = r / 3;
+                digit[d - 1] = (unsigned char)(r - above * 3);
+                phase[d] = (unsigned char)((2 * odd + r - above) & 3);
+                r = above;
+            }
+            continue;
+        }
+        
+        // A move of a disk above the blocks, or every move when n < L
+        int i = 0;
+        while (digit[i] == 2) digit[i++] = 0;
+        digit[i]++;
+        int p = phase[i + 1];
+        phase[i + 1] = (unsigned char)((p + 1) & 3);
+        out[count++] = HANOI_PACK_MOVE(i + 1, adjacentSweep[p], adjacentSweep[p + 1]);
+        odd ^= i >= VARIANT_LEAF_DISKS;
+    }
+    return count;
+}
+
+static size_t cyclicFill(HanoiVariantStream *s, HanoiPackedMove *out, size_t max) {
+    const VariantLeaves *leaves = variantLeavesGet();
+    size_t count = 0;
+    
+    while (count < max) {
+        HanoiVariantFrame *f = &s->frame[s->depth - 1];
+        const CyclicItem *item = &cyclicScript[f->kind][f->step++];
+        int m = f->disks - 1, src = (f->src + item->a) % 3;
+        
+        if (item->op == CYCLIC_MOVE) {
+            out[count++] = HANOI_PACK_MOVE(f->disks, src, (f->src + item->b) % 3);
+        } else if (item->op == CYCLIC_END) {
+            s->depth--;
+        } else if (m == 0) {
+            continue;
+        } else if (leaves && m <= VARIANT_LEAF_DISKS && leaves->cyclicLength[item->op][m] <= max - count) {
+            memcpy(out + count, leaves->cyclic[item->op][m][src], leaves->cyclicLength[item->op][m] * sizeof(HanoiPackedMove));
+            count += leaves->cyclicLength[item->op][m];
+        } else {
+            HanoiVariantFrame sub = { (unsigned char)m, item->op, (unsigned char)src, 0 };
+            s->frame[s->depth++] = sub;
+        }
+    }
+    return count;
+}
+
+// Write up to max next moves; returns how many, 0 once finished
+size_t hanoiVariantStreamFill(HanoiVariantStream *s, HanoiPackedMove *out, size_t max) {
+    if (s->next > s->total) return 0;
+    if (max > s->total - s->next + 1) max = (size_t)(s->total - s->next + 1);
+    
+    size_t count = s->variant == HANOI_VARIANT_ADJACENT ? adjacentFill(s, out, max) : cyclicFill(s, out, max);
+    s->next += count;
+    return count;
+}
+
+THREAD_LOCAL unsigned long long hanoiVariantChecksum;   // keeps benchmark output observable
+
+static void variantSolve(int variant, int n) {
+    HanoiVariantStream s;
+    size_t mark = hanoiArenaMark();
+    HanoiPackedMove *out = engineChunk();
+    size_t got;
+    
+    if (out && hanoiVariantStreamInit(&s, variant, n)) {
+        while ((got = hanoiVariantStreamFill(&s, out, HANOI_BLOCK_CHUNK_MOVES)) > 0) hanoiVariantChecksum += out[got - 1] + got;
+    }
+    engineChunkRelease(out);
+    hanoiArenaRelease(mark);
+}
+
+void hanoiSolveAdjacent(int n) {
+    variantSolve(HANOI_VARIANT_ADJACENT, n);
+}
+
+void hanoiSolveCyclic(int n) {
+    variantSolve(HANOI_VARIANT_CYCLIC, n);
+}
+
+static unsigned long long variantEngineMoves(int variant, int n) {
+    HanoiMoveIndex count = hanoiVariantMoveCount(variant, n);
+    return (count >> 64) ? ~0ULL : (unsigned long long)count;
+}
+
+unsigned long long hanoiAdjacentEngineMoves(int n) {
+    return variantEngineMoves(HANOI_VARIANT_ADJACENT, n);
+}
+
+unsigned long long hanoiCyclicEngineMoves(int n) {
+    return variantEngineMoves(HANOI_VARIANT_CYCLIC, n);
+}
+
+// Replay the stream, filled in pieces of varying size, on bitboards: every
+// move legal and allowed by the variant, all disks end on C, and sampled
+// moves (every move up to 10 disks) match the random-access k-th move
+static int variantVerify(int variant, int n) {
+    HanoiVariantStream s;
+    HanoiPackedMove out[1000];
+    uint64_t peg[3] = { 0, 0, 0 };
+    uint64_t all = (n < 64) ? (1ULL << n) - 1 : ~0ULL;
+    unsigned long long k = 0;
+    size_t got, piece = 1;
+    
+    if (n > 63 || !hanoiVariantStreamInit(&s, variant, n)) return 0;
+    peg[0] = all;
+    while ((got = hanoiVariantStreamFill(&s, out, piece)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            int from = HANOI_PACKED_FROM(out[i]), to = HANOI_PACKED_TO(out[i]);
+            uint64_t bit = 1ULL << (HANOI_PACKED_DISK(out[i]) - 1);
+            int allowed = variant == HANOI_VARIANT_ADJACENT ? from + to == 1 || from + to == 3 : to == (from + 1) % 3;
+            
+            k++;
+            if (!allowed || !(peg[from] & bit) || (peg[from] & (bit - 1)) || (peg[to] & (bit - 1))) return 0;
+            peg[from] &= ~bit;
+            peg[to] |= bit;
+            
+            if (n <= 10 || (k & 1023) == 1) {
+                HanoiMove m = hanoiVariantKthMove(variant, n, k);
+                if (out[i] != HANOI_PACK_MOVE(m.disk, m.from, m.to)) return 0;
+            }
+        }
+        piece = piece * 7 % 997 + 1;
+    }
+    return k == s.total && peg[2] == all;
+}
+
+int hanoiVerifyAdjacent(int n) {
+    return variantVerify(HANOI_VARIANT_ADJACENT, n);
+}
+
+int hanoiVerifyCyclic(int n) {
+    return variantVerify(HANOI_VARIANT_CYCLIC, n);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  STATE-SPACE BREADTH-FIRST SEARCH
+// ═══════════════════════════════════════════════════════════
+// Level-synchronous BFS over all 3^n configurations. A configuration is the
+// base-3 number whose digit d-1 is the peg of disk d, and the visited set is
+// one bit per configuration (436 MB for n = 20). The Hanoi graph has about
+// 2^n levels holding (3/2)^n states on average, so rescanning a frontier
+// bitmap every level would cost 3^n per level; frontiers are lists of state
+// indices instead. Each worker appends its discoveries to its own list and
+// the next level reads those lists as one concatenation (prefix offsets), so
+// a level costs one barrier and no copying. Levels of fewer than
+// BFS_SERIAL_LEVEL states, too small to pay for a barrier, are expanded by
+// thread 0 alone, back to back, while the others wait. The cutoff does not
+// depend on the thread count; at n = 18 such levels hold about 4% of the
+// states (about 30% at n = 14).
+#define BFS_SERIAL_LEVEL 512
+
+typedef struct {
+    uint32_t *items;
+    size_t count;
+    size_t capacity;
+} StateList;
+
+typedef struct {
+    int n;
+    int threads;
+    uint32_t pow3[HANOI_BFS_MAX_DISKS + 1];
+    uint64_t *visited;
+    uint32_t target;
+    
+    StateList lists[2][HANOI_MAX_THREADS];   // frontier parts, by level parity
+    int failed[2];                           // lists[p] is incomplete (out of memory)
+    int parity;                              // frontier after a serial stretch
+    unsigned long long expanded[HANOI_MAX_THREADS];
+    
+    long long level;           // deepest non-empty level so far
+    long long targetLevel;     // -1 until the target is discovered
+    unsigned long long reached;
+    unsigned long long *levelSizes;
+    Barrier barrier;
+} BfsRun;
+
+static int stateListPush(StateList *list, uint32_t value) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 4096;
+        uint32_t *items = (uint32_t *)hanoiRealloc(list->items, capacity * sizeof(uint32_t));
+        if (!items) return 0;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = value;
+    return 1;
+}
+
+static uint32_t configToState(int n, const int *pegOf, const uint32_t *pow3) {
+    uint32_t state = 0;
+    for (int d = 1; d <= n; d++) state += (uint32_t)pegOf[d] * pow3[d - 1];
+    return state;
+}
+
+// Neighbours of a configuration: the smallest disk of each peg can move to
+// any peg whose top disk is larger (or that is empty)
+static int bfsNeighbours(const BfsRun *run, uint32_t state, uint32_t *out) {
+    int top[3] = { 0, 0, 0 };
+    int found = 0;
+    uint32_t rest = state;
+    
+    for (int d = 1; d <= run->n && found < 3; d++) {
+        int peg = rest % 3;
+        rest /= 3;
+        if (!top[peg]) {
+            top[peg] = d;
+            found++;
+        }
+    }
+    
+    int count = 0;
+    for (int a = 0; a < 3; a++) {
+        if (!top[a]) continue;
+        for (int b = 0; b < 3; b++) {
+            if (a == b || (top[b] && top[b] < top[a])) continue;
+            out[count++] = state + (uint32_t)(b - a) * run->pow3[top[a] - 1];
+        }
+    }
+    return count;
+}
+
+static size_t bfsFrontierSize(const BfsRun *run, int parity) {
+    size_t total = 0;
+    for (int t = 0; t < run->threads; t++) total += run->lists[parity][t].count;
+    return total;
+}
+
+// Expand states [lo, hi) of the frontier lists[parity] (one level) into
+// next. Returns 0 when next cannot grow.
+static int bfsExpand(BfsRun *run, int parity, size_t lo, size_t hi, long long level, StateList *next) {
+    uint32_t neighbours[3];
+    size_t offset = 0;
+    
+    for (int t = 0; t < run->threads && offset < hi; t++) {
+        const StateList *part = &run->lists[parity][t];
+        size_t first = lo > offset ? lo - offset : 0;
+        size_t last = hi - offset < part->count ? hi - offset : part->count;
+        
+        for (size_t i = first; i < last; i++) {
+            int count = bfsNeighbours(run, part->items[i], neighbours);
+            for (int j = 0; j < count; j++) {
+                uint32_t s = neighbours[j];
+                uint64_t bit = 1ULL << (s & 63);
+                uint64_t *word = &run->visited[s >> 6];
+                
+                if (__atomic_load_n(word, __ATOMIC_RELAXED) & bit) continue;
+                if (__atomic_fetch_or(word, bit, __ATOMIC_RELAXED) & bit) continue;
+                
+                if (!stateListPush(next, s)) return 0;
+                if (s == run->target) __atomic_store_n(&run->targetLevel, level + 1, __ATOMIC_RELAXED);
+            }
+        }
+        offset += part->count;
+    }
+    return 1;
+}
+
+static void bfsRecordLevel(BfsRun *run, size_t size) {
+    run->level++;
+    run->reached += size;
+    run->levelSizes[run->level] = size;
+}
+
+// Thread 0 alone: expand levels while they stay narrow, then publish the
+// parity holding the frontier
+static void bfsSerial(BfsRun *run, int parity, long long level) {
+    size_t total = bfsFrontierSize(run, parity);
+    
+    while (total > 0 && (run->threads == 1 || total < BFS_SERIAL_LEVEL)) {
+        StateList *next = &run->lists[parity ^ 1][0];
+        for (int t = 0; t < run->threads; t++) run->lists[parity ^ 1][t].count = 0;
+        
+        int ok = bfsExpand(run, parity, 0, total, level, next);
+        run->expanded[0] += total;
+        parity ^= 1;
+        level++;
+        if (!ok) {
+            run->failed[parity] = 1;
+            break;
+        }
+        total = next->count;
+        if (total) bfsRecordLevel(run, total);
+    }
+    run->parity = parity;
+}
+
+static void bfsWorker(int id, void *ctx) {
+    BfsRun *run = (BfsRun *)ctx;
+    int parity = 0;
+    long long level = 0;
+    
+    while (1) {
+        // Every thread reaches the same decision: the counts and flags read
+        // here were written before the last barrier
+        size_t total = bfsFrontierSize(run, parity);
+        if (total == 0 || run->failed[parity]) break;
+        
+        if (run->threads == 1 || total < BFS_SERIAL_LEVEL) {
+            // The stretch rewrites both parities: wait until every thread
+            // has counted this frontier
+            hanoiBarrierWait(&run->barrier);
+            if (id == 0) bfsSerial(run, parity, level);
+            hanoiBarrierWait(&run->barrier);
+            parity = run->parity;
+            level = run->level;
+            continue;
+        }
+        
+        // Static slice of the concatenated frontier
+        size_t lo = total * id / run->threads;
+        size_t hi = total * (id + 1) / run->threads;
+        StateList *next = &run->lists[parity ^ 1][id];
+        
+        next->count = 0;
+        if (!bfsExpand(run, parity, lo, hi, level, next)) {
+            __atomic_store_n(&run->failed[parity ^ 1], 1, __ATOMIC_RELAXED);
+        }
+        run->expanded[id] += hi - lo;
+        
+        hanoiBarrierWait(&run->barrier);
+        parity ^= 1;
+        level++;
+        if (id == 0) {
+            size_t size = bfsFrontierSize(run, parity);
+            if (size) bfsRecordLevel(run, size);
+        }
+    }
+}
+
+// BFS from `start` (pegOf[1..n]). Fills result and, when levelSizes is not
+// NULL, returns a malloc'd array of states per level (0..result->levels).
+// Returns 0 when memory runs out (visited set or frontier lists).
+int hanoiBfsExplore(int n, const int *start, const int *target, int threads,
+               HanoiBfsResult *result, unsigned long long **levelSizes) {
+    BfsRun *run = (BfsRun *)hanoiCalloc(1, sizeof(BfsRun));
+    if (!run || n < 1 || n > HANOI_BFS_MAX_DISKS) {
+        free(run);
+        return 0;
+    }
+    
+    run->n = n;
+    run->threads = threads < 1 ? 1 : (threads > HANOI_MAX_THREADS ? HANOI_MAX_THREADS : threads);
+    run->pow3[0] = 1;
+    for (int d = 1; d <= n; d++) run->pow3[d] = run->pow3[d - 1] * 3;
+    
+    // The n-disk graph has diameter 2^n - 1, so 2^n level entries suffice
+    uint64_t states = run->pow3[n];
+    run->visited = (uint64_t *)hanoiCalloc((states + 63) / 64, sizeof(uint64_t));
+    run->levelSizes = (unsigned long long *)hanoiMalloc(((size_t)1 << n) * sizeof(unsigned long long));
+    
+    uint32_t source = configToState(n, start, run->pow3);
+    int ok = run->visited && run->levelSizes && stateListPush(&run->lists[0][0], source);
+    
+    if (ok) {
+        run->target = target ? configToState(n, target, run->pow3) : UINT32_MAX;
+        run->targetLevel = (run->target == source) ? 0 : -1;
+        run->visited[source >> 6] |= 1ULL << (source & 63);
+        run->reached = 1;
+        run->levelSizes[0] = 1;
+        hanoiBarrierInit(&run->barrier, run->threads);
+        
+        long long startNs = hanoiNowNs();
+        hanoiParallelRun(run->threads, bfsWorker, run);
+        hanoiBarrierDestroy(&run->barrier);
+        ok = !run->failed[0] && !run->failed[1];
+        
+        result->n = n;
+        result->threads = run->threads;
+        result->seconds = (hanoiNowNs() - startNs) / 1e9;
+        result->states = run->reached;
+        result->levels = run->level;
+        result->targetDistance = run->targetLevel;
+        for (int t = 0; t < run->threads; t++) result->expanded[t] = run->expanded[t];
+    }
+    
+    if (ok && levelSizes) *levelSizes = run->levelSizes;
+    else free(run->levelSizes);
+    
+    for (int p = 0; p < 2; p++) {
+        for (int t = 0; t < run->threads; t++) free(run->lists[p][t].items);
+    }
+    free(run->visited);
+    free(run);
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  MOVE TRACE FILES
+// ═══════════════════════════════════════════════════════════
+// Layout (little-endian):
+//   HanoiTraceHeader (64 bytes)
+//   move data, 2 bits per move, 4 moves per byte (first move in the low bits)
+//   block index, one HanoiTraceIndexEntry per HANOI_TRACE_BLOCK_MOVES moves
+// A move only stores which pair of pegs it uses (A-B, A-C or B-C): between
+// two pegs exactly one direction is legal, the same rule hanoiLegalMove
+// applies, so disk and direction are recovered by replaying from the state
+// stored in the index for the move's block.
+static int tracePairCode(int from, int to) {
+    return from + to - 1;      // A-B = 0, A-C = 1, B-C = 2
+}
+
+// Start a trace of an n-disk puzzle (n <= 63) from pegOf, or all disks on A
+// when pegOf is NULL. Returns 0 on failure.
+int hanoiTraceWriterOpen(HanoiTraceWriter *w, const char *path, int n, const int *pegOf) {
+    memset(w, 0, sizeof(*w));
+    if (n < 1 || n > 63) return 0;
+    
+    w->file = fopen(path, "wb");
+    if (!w->file) return 0;
+    w->buffer = (uint8_t *)hanoiMalloc(HANOI_TRACE_BUFFER_BYTES);
+    w->indexCapacity = 1024;
+    w->index = (HanoiTraceIndexEntry *)hanoiMalloc(w->indexCapacity * sizeof(HanoiTraceIndexEntry));
+    if (!w->buffer || !w->index) {
+        fclose(w->file);
+        free(w->buffer);
+        free(w->index);
+        return 0;
+    }
+    
+    for (int p = 0; p < 3; p++) w->peg[p] = BITBOARD_FLOOR;
+    for (int d = 1; d <= n; d++) w->peg[pegOf ? pegOf[d] : 0] |= 1ULL << (d - 1);
+    
+    memcpy(w->header.magic, HANOI_TRACE_MAGIC, 4);
+    w->header.version = HANOI_TRACE_VERSION;
+    w->header.disks = n;
+    w->header.blockMoves = HANOI_TRACE_BLOCK_MOVES;
+    for (int p = 0; p < 3; p++) w->header.startPeg[p] = w->peg[p] & ~BITBOARD_FLOOR;
+    
+    // Placeholder header, rewritten with the final counts on close
+    fwrite(&w->header, sizeof(HanoiTraceHeader), 1, w->file);
+    return 1;
+}
+
+// Moves after an allocation failure are dropped; hanoiTraceWriterClose reports it
+void hanoiTraceWriterAppend(HanoiTraceWriter *w, int from, int to) {
+    uint64_t k = w->header.totalMoves;
+    
+    if (w->failed) return;
+    if (k % HANOI_TRACE_BLOCK_MOVES == 0) {
+        if (w->indexCount == w->indexCapacity) {
+            HanoiTraceIndexEntry *index = (HanoiTraceIndexEntry *)hanoiRealloc(w->index,
+                                            2 * w->indexCapacity * sizeof(HanoiTraceIndexEntry));
+            if (!index) {
+                w->failed = 1;
+                return;
+            }
+            w->index = index;
+            w->indexCapacity *= 2;
+        }
+        for (int p = 0; p < 3; p++) w->index[w->indexCount].peg[p] = w->peg[p] & ~BITBOARD_FLOOR;
+        w->indexCount++;
+    }
+    
+    BITBOARD_MOVE(w->peg[from], w->peg[to]);
+    
+    w->pending |= (uint8_t)(tracePairCode(from, to) << (2 * (k & 3)));
+    if ((k & 3) == 3) {
+        w->buffer[w->used++] = w->pending;
+        w->pending = 0;
+        if (w->used == HANOI_TRACE_BUFFER_BYTES) {
+            fwrite(w->buffer, 1, w->used, w->file);
+            w->used = 0;
+        }
+    }
+    w->header.totalMoves = k + 1;
+}
+
+// Flush data, append the block index and finalise the header. Returns 0 on
+// I/O error or when an append ran out of memory.
+int hanoiTraceWriterClose(HanoiTraceWriter *w) {
+    if (w->header.totalMoves & 3) w->buffer[w->used++] = w->pending;
+    fwrite(w->buffer, 1, w->used, w->file);
+    
+    w->header.indexOffset = sizeof(HanoiTraceHeader) + (w->header.totalMoves + 3) / 4;
+    // Keep the index 8-byte aligned for the memory-mapped reader
+    while (w->header.indexOffset % 8) {
+        fputc(0, w->file);
+        w->header.indexOffset++;
+    }
+    fwrite(w->index, sizeof(HanoiTraceIndexEntry), w->indexCount, w->file);
+    
+    fseek(w->file, 0, SEEK_SET);
+    fwrite(&w->header, sizeof(HanoiTraceHeader), 1, w->file);
+    
+    int ok = !ferror(w->file) && !w->failed;
+    if (fclose(w->file) != 0) ok = 0;
+    free(w->buffer);
+    free(w->index);
+    return ok;
+}
+
+void hanoiTraceReaderClose(HanoiTraceReader *r) {
+    if (!r->base) return;
+    #ifdef _WIN32
+    UnmapViewOfFile(r->base);
+    CloseHandle(r->mapping);
+    CloseHandle(r->file);
+    #else
+    munmap((void *)r->base, r->size);
+    #endif
+    r->base = NULL;
+}
+
+// Memory-map a trace file for zero-copy random access. Returns 0 when the
+// file cannot be mapped or is not a valid trace.
+int hanoiTraceReaderOpen(HanoiTraceReader *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    
+    #ifdef _WIN32
+    r->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (r->file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER size;
+    GetFileSizeEx(r->file, &size);
+    r->size = (size_t)size.QuadPart;
+    r->mapping = CreateFileMappingA(r->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!r->mapping) { CloseHandle(r->file); return 0; }
+    r->base = (const uint8_t *)MapViewOfFile(r->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!r->base) { CloseHandle(r->mapping); CloseHandle(r->file); return 0; }
+    #else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(HanoiTraceHeader)) { close(fd); return 0; }
+    r->size = (size_t)st.st_size;
+    void *map = mmap(NULL, r->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+    r->base = (const uint8_t *)map;
+    #endif
+    
+    if (r->size < sizeof(HanoiTraceHeader)) {
+        hanoiTraceReaderClose(r);
+        return 0;
+    }
+    
+    // The 2-bit data must fit between the header and the index, and the
+    // index must hold one entry per block (all computed without overflow)
+    const HanoiTraceHeader *h = (const HanoiTraceHeader *)r->base;
+    uint64_t dataBytes = (h->totalMoves >> 2) + ((h->totalMoves & 3) != 0);
+    uint64_t blocks = h->totalMoves / HANOI_TRACE_BLOCK_MOVES + (h->totalMoves % HANOI_TRACE_BLOCK_MOVES != 0);
+    if (memcmp(h->magic, HANOI_TRACE_MAGIC, 4) != 0
+        || h->version != HANOI_TRACE_VERSION || h->disks < 1 || h->disks > 63
+        || h->blockMoves != HANOI_TRACE_BLOCK_MOVES
+        || h->indexOffset < sizeof(HanoiTraceHeader) || h->indexOffset > r->size
+        || h->indexOffset - sizeof(HanoiTraceHeader) < dataBytes
+        || (r->size - h->indexOffset) / sizeof(HanoiTraceIndexEntry) < blocks) {
+        hanoiTraceReaderClose(r);
+        return 0;
+    }
+    
+    r->header = h;
+    r->data = r->base + sizeof(HanoiTraceHeader);
+    r->index = (const HanoiTraceIndexEntry *)(r->base + h->indexOffset);
+    return 1;
+}
+
+// Decode `count` moves starting at move `first` (0-based) into out. Only the
+// block containing `first` is replayed, never the moves before it.
+// Returns the number of moves decoded.
+uint64_t hanoiTraceReadMoves(const HanoiTraceReader *r, uint64_t first, uint64_t count, HanoiMove *out) {
+    uint64_t total = r->header->totalMoves;
+    if (first >= total) return 0;
+    if (count > total - first) count = total - first;
+    
+    uint64_t blockMoves = r->header->blockMoves;
+    uint64_t k = first - first % blockMoves;
+    const HanoiTraceIndexEntry *entry = &r->index[first / blockMoves];
+    uint64_t peg[3];
+    for (int p = 0; p < 3; p++) peg[p] = entry->peg[p] | BITBOARD_FLOOR;
+    
+    static const int pairFrom[3] = { 0, 0, 1 };
+    static const int pairTo[3] = { 1, 2, 2 };
+    
+    for (uint64_t end = first + count; k < end; k++) {
+        int code = (r->data[k >> 2] >> (2 * (k & 3))) & 3;
+        if (code > 2) return k > first ? k - first : 0;
+        
+        int a = pairFrom[code], b = pairTo[code];
+        uint64_t topA = peg[a] & (0 - peg[a]);
+        uint64_t topB = peg[b] & (0 - peg[b]);
+        int from = topA < topB ? a : b;
+        int to = topA < topB ? b : a;
+        uint64_t bit = topA < topB ? topA : topB;
+        peg[a] ^= bit;
+        peg[b] ^= bit;
+        
+        if (k >= first) {
+            HanoiMove *m = &out[k - first];
+            m->disk = __builtin_ctzll(bit) + 1;
+            m->from = from;
+            m->to = to;
+        }
+    }
+    return count;
+}
+
+// Recursive engine writing every move to a trace
+void hanoiTrace(int n, char source, char dest, char aux, HanoiTraceWriter *w) {
+    if (n == 1) {
+        hanoiTraceWriterAppend(w, source - 'A', dest - 'A');
+        return;
+    }
+    hanoiTrace(n - 1, source, aux, dest, w);
+    hanoiTraceWriterAppend(w, source - 'A', dest - 'A');
+    hanoiTrace(n - 1, aux, dest, source, w);
+}
+
+// hanoiLegalMove that also records the move it made, using the peg names
+static void legalMoveTraced(Stack *A, Stack *B, char nameA, char nameB, HanoiTraceWriter *w) {
+    int topA = hanoiStackPeek(A);
+    int topB = hanoiStackPeek(B);
+    
+    if (topA == 0 || (topB != 0 && topA > topB)) {
+        hanoiStackPush(A, hanoiStackPop(B));
+        hanoiTraceWriterAppend(w, nameB - 'A', nameA - 'A');
+    } else {
+        hanoiStackPush(B, hanoiStackPop(A));
+        hanoiTraceWriterAppend(w, nameA - 'A', nameB - 'A');
+    }
+}
+
+// Stack engine writing every move to a trace; 0 when the pegs cannot be allocated
+int hanoiIterativeTrace(int n, HanoiTraceWriter *w) {
+    Stack pegs[3];
+    for (int p = 0; p < 3; p++) pegs[p] = hanoiStackCreate(n);
+    if (!pegs[0].arr || !pegs[1].arr || !pegs[2].arr) {
+        for (int p = 0; p < 3; p++) free(pegs[p].arr);
+        return 0;
+    }
+    for (int i = n; i >= 1; i--) hanoiStackPush(&pegs[0], i);
+    
+    Stack *src = &pegs[0], *aux = &pegs[1], *dest = &pegs[2];
+    char S = 'A', A = 'B', D = 'C';
+    if (n % 2 == 0) {
+        Stack *t = dest; dest = aux; aux = t;
+        char c = D; D = A; A = c;
+    }
+    
+    long long totalMoves = (1LL << n) - 1;
+    for (long long i = 1; i <= totalMoves; i++) {
+        if (i % 3 == 1) legalMoveTraced(src, dest, S, D, w);
+        else if (i % 3 == 2) legalMoveTraced(src, aux, S, A, w);
+        else legalMoveTraced(aux, dest, A, D, w);
+    }
+    
+    for (int p = 0; p < 3; p++) free(pegs[p].arr);
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  MOVE-STREAM VALIDATOR
+// ═══════════════════════════════════════════════════════════
+// Checks any stream of packed moves for an n-disk, 3-peg puzzle (n <= 63):
+// every move must take the top disk of a non-empty peg onto an empty peg
+// or a larger disk, and the last state must be the target. Moves are
+// buffered into batches of HANOI_VALIDATE_CHUNK_MOVES-move chunks, and each batch
+// is checked in two parallel passes:
+//   1. per chunk, the last peg each disk is moved to (needs no start state)
+//   2. per chunk, full legality from its start state, which is rebuilt
+//      sequentially from the previous chunk's start and its pass-1 result
+// Since pass 2 starts every chunk from the exact state the moves before it
+// produce, the result is the same as one sequential replay.
+typedef struct {
+    HanoiValidator *v;
+    int chunkCount;
+    int pass;
+    int next;                         // next chunk to claim
+} ValidateJob;
+
+// pegOf[1..n] to bitboard masks with the floor bit
+static void pegsToBitboard(int n, const int *pegOf, uint64_t *peg) {
+    for (int p = 0; p < 3; p++) peg[p] = BITBOARD_FLOOR;
+    for (int d = 1; d <= n; d++) peg[pegOf[d]] |= 1ULL << (d - 1);
+}
+
+// start/target NULL mean all disks on A / all disks on C. Returns 0 on
+// allocation failure.
+int hanoiValidatorInit(HanoiValidator *v, int n, const int *start, const int *target, int threads) {
+    int pegOf[HANOI_VALIDATE_MAX_DISKS + 1] = { 0 };
+    
+    memset(v, 0, sizeof(*v));
+    if (threads < 1) threads = 1;
+    if (threads > HANOI_MAX_THREADS) threads = HANOI_MAX_THREADS;
+    v->n = n;
+    v->threads = threads;
+    
+    for (int d = 1; d <= n; d++) pegOf[d] = 0;
+    pegsToBitboard(n, start ? start : pegOf, v->peg);
+    for (int d = 1; d <= n; d++) pegOf[d] = 2;
+    pegsToBitboard(n, target ? target : pegOf, v->target);
+    
+    int chunkCount = threads * HANOI_VALIDATE_CHUNKS_PER_THREAD;
+    v->capacity = (size_t)chunkCount * HANOI_VALIDATE_CHUNK_MOVES;
+    v->buffer = (HanoiPackedMove *)hanoiMalloc(v->capacity * sizeof(HanoiPackedMove));
+    v->chunks = (HanoiValidateChunk *)hanoiMalloc(chunkCount * sizeof(HanoiValidateChunk));
+    if (!v->buffer || !v->chunks) {
+        free(v->buffer);
+        free(v->chunks);
+        return 0;
+    }
+    return 1;
+}
+
+static void validateLastPegs(HanoiValidateChunk *c, int n) {
+    memset(c->lastPeg, -1, sizeof(c->lastPeg));
+    for (size_t i = 0; i < c->count; i++) {
+        int d = HANOI_PACKED_DISK(c->moves[i]);
+        if (d >= 1 && d <= n) c->lastPeg[d] = (signed char)HANOI_PACKED_TO(c->moves[i]);
+    }
+}
+
+static void validateLegality(HanoiValidateChunk *c, int n) {
+    uint64_t peg[3] = { c->start[0], c->start[1], c->start[2] };
+    
+    c->badAt = 0;
+    for (size_t i = 0; i < c->count; i++) {
+        HanoiPackedMove m = c->moves[i];
+        int d = HANOI_PACKED_DISK(m), from = HANOI_PACKED_FROM(m), to = HANOI_PACKED_TO(m);
+        
+        if (d < 1 || d > n || from > 2 || to > 2 || from == to) {
+            c->reason = "malformed move";
+        } else {
+            uint64_t bit = 1ULL << (d - 1);
+            if ((peg[from] & (0 - peg[from])) != bit) {
+                c->reason = (peg[from] == BITBOARD_FLOOR) ? "source peg is empty" : "disk is not on top of the source peg";
+            } else if ((peg[to] & (0 - peg[to])) < bit) {
+                c->reason = "larger disk placed on a smaller one";
+            } else {
+                peg[from] ^= bit;
+                peg[to] ^= bit;
+                continue;
+            }
+        }
+        c->badAt = i + 1;
+        return;
+    }
+}
+
+static void validateWorker(int id, void *arg) {
+    ValidateJob *job = (ValidateJob *)arg;
+    (void)id;
+    
+    while (1) {
+        int c = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (c >= job->chunkCount) return;
+        if (job->pass == 1) validateLastPegs(&job->v->chunks[c], job->v->n);
+        else validateLegality(&job->v->chunks[c], job->v->n);
+    }
+}
+
+// Apply a chunk's pass-1 result to a state
+static void validateAdvance(int n, const HanoiValidateChunk *c, const uint64_t *in, uint64_t *out) {
+    for (int p = 0; p < 3; p++) out[p] = in[p];
+    for (int d = 1; d <= n; d++) {
+        int p = c->lastPeg[d];
+        if (p < 0 || p > 2) continue;
+        uint64_t bit = 1ULL << (d - 1);
+        out[0] &= ~bit;
+        out[1] &= ~bit;
+        out[2] &= ~bit;
+        out[p] |= bit;
+    }
+}
+
+static void validatorRunBatch(HanoiValidator *v) {
+    if (v->used == 0 || v->firstBad) {
+        v->used = 0;
+        return;
+    }
+    
+    ValidateJob job = { v, 0, 1, 0 };
+    for (size_t first = 0; first < v->used; first += HANOI_VALIDATE_CHUNK_MOVES) {
+        HanoiValidateChunk *c = &v->chunks[job.chunkCount++];
+        c->moves = v->buffer + first;
+        c->count = (v->used - first < HANOI_VALIDATE_CHUNK_MOVES) ? v->used - first : HANOI_VALIDATE_CHUNK_MOVES;
+    }
+    int threads = job.chunkCount < v->threads ? job.chunkCount : v->threads;
+    
+    hanoiParallelRun(threads, validateWorker, &job);
+    
+    uint64_t state[3] = { v->peg[0], v->peg[1], v->peg[2] };
+    for (int c = 0; c < job.chunkCount; c++) {
+        for (int p = 0; p < 3; p++) v->chunks[c].start[p] = state[p];
+        validateAdvance(v->n, &v->chunks[c], v->chunks[c].start, state);
+    }
+    
+    job.pass = 2;
+    job.next = 0;
+    hanoiParallelRun(threads, validateWorker, &job);
+    
+    for (int c = 0; c < job.chunkCount; c++) {
+        if (v->chunks[c].badAt) {
+            v->firstBad = v->validated + (unsigned long long)c * HANOI_VALIDATE_CHUNK_MOVES + v->chunks[c].badAt;
+            v->reason = v->chunks[c].reason;
+            break;
+        }
+    }
+    for (int p = 0; p < 3; p++) v->peg[p] = state[p];
+    v->validated += v->used;
+    v->used = 0;
+}
+
+void hanoiValidatorPush(HanoiValidator *v, const HanoiPackedMove *moves, size_t count) {
+    while (count > 0 && !v->firstBad) {
+        size_t take = v->capacity - v->used;
+        if (take > count) take = count;
+        memcpy(v->buffer + v->used, moves, take * sizeof(HanoiPackedMove));
+        v->used += take;
+        moves += take;
+        count -= take;
+        if (v->used == v->capacity) validatorRunBatch(v);
+    }
+}
+
+// Flush callback for the block generator
+void hanoiValidatorFlush(const HanoiPackedMove *moves, size_t count, void *ctx) {
+    hanoiValidatorPush((HanoiValidator *)ctx, moves, count);
+}
+
+void hanoiValidatorPushMoves(HanoiValidator *v, const HanoiMove *moves, size_t count) {
+    HanoiPackedMove packed[1024];
+    while (count > 0) {
+        size_t take = count < 1024 ? count : 1024;
+        for (size_t i = 0; i < take; i++) {
+            int disk = (moves[i].disk >= 0 && moves[i].disk <= HANOI_VALIDATE_MAX_DISKS) ? moves[i].disk : 0;
+            packed[i] = HANOI_PACK_MOVE(disk, moves[i].from & 3, moves[i].to & 3);
+        }
+        hanoiValidatorPush(v, packed, take);
+        moves += take;
+        count -= take;
+    }
+}
+
+// Validates what is left and frees the buffers. Returns 1 when every move
+// was legal and the final state is the target.
+int hanoiValidatorFinish(HanoiValidator *v) {
+    validatorRunBatch(v);
+    if (!v->firstBad && memcmp(v->peg, v->target, sizeof(v->peg)) != 0) {
+        v->reason = "final state is not the target";
+    }
+    free(v->buffer);
+    free(v->chunks);
+    v->buffer = NULL;
+    v->chunks = NULL;
+    return !v->firstBad && !v->reason;
+}
+
+// Text moves as printed by --solve and --trace-read: "step,disk,from,to".
+// Blank lines and the header lines before the first move are skipped.
+// Returns 0 on a malformed line.
+int hanoiValidateText(HanoiValidator *v, FILE *f) {
+    char line[256];
+    int started = 0;
+    HanoiMove m;
+    
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long step;
+        char from, to;
+        if (line[0] == '\n' || line[0] == '\r') continue;
+        if (sscanf(line, "%llu,%d,%c,%c", &step, &m.disk, &from, &to) != 4
+            || from < 'A' || from > 'C' || to < 'A' || to > 'C') {
+            if (started) return 0;
+            continue;
+        }
+        started = 1;
+        m.from = from - 'A';
+        m.to = to - 'A';
+        hanoiValidatorPushMoves(v, &m, 1);
+    }
+    return 1;
+}
+
+// Decode a trace block range at a time; each call restarts from the
+// state stored in the trace index, so a corrupt index shows up as an
+// illegal move
+void hanoiValidateTrace(HanoiValidator *v, const HanoiTraceReader *r) {
+    HanoiMove *moves = (HanoiMove *)hanoiMalloc(HANOI_TRACE_BLOCK_MOVES * sizeof(HanoiMove));
+    if (!moves) return;
+    
+    uint64_t total = r->header->totalMoves;
+    for (uint64_t k = 0; k < total && !v->firstBad; ) {
+        uint64_t got = hanoiTraceReadMoves(r, k, HANOI_TRACE_BLOCK_MOVES, moves);
+        if (got == 0) {
+            v->firstBad = k + 1;
+            v->reason = "undecodable trace data";
+            break;
+        }
+        hanoiValidatorPushMoves(v, moves, (size_t)got);
+        k += got;
+    }
+    free(moves);
+}
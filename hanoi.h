@@ -0,0 +1,310 @@
+// hanoi.h - libhanoi: Tower of Hanoi solvers, random access, search,
+// move traces and validation. Nothing here writes to the terminal; results
+// come back through return values and caller-supplied buffers. Every
+// exported name starts with hanoi / Hanoi / HANOI_; the benchmark plumbing
+// behind the engines lives in hanoi_internal.h.
+#ifndef HANOI_H
+#define HANOI_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// libhanoi.so is built with -fvisibility=hidden and exports only these
+#if defined(__GNUC__)
+#define HANOI_API __attribute__((visibility("default")))
+#else
+#define HANOI_API
+#endif
+
+// ═══════════════════════════════════════════════════════════
+//  MOVES AND INDICES
+// ═══════════════════════════════════════════════════════════
+// Exact move indices and counts for up to HANOI_MAX_DISKS disks
+#ifndef __SIZEOF_INT128__
+#error "unsigned __int128 is required (GCC or Clang on a 64-bit target)"
+#endif
+typedef unsigned __int128 HanoiMoveIndex;
+#define HANOI_MAX_DISKS   127
+#define HANOI_MAX_THREADS 256
+
+// Pegs are numbered 0, 1, 2 for A, B, C. Disks are numbered 1 (smallest) to n.
+typedef struct {
+    int disk;
+    int from;
+    int to;
+} HanoiMove;
+
+typedef uint16_t HanoiPackedMove;   // disk << 4 | from << 2 | to
+
+#define HANOI_PACK_MOVE(d, f, t)  ((HanoiPackedMove)((d) << 4 | (f) << 2 | (t)))
+#define HANOI_PACKED_DISK(m)      ((m) >> 4)
+#define HANOI_PACKED_FROM(m)      (((m) >> 2) & 3)
+#define HANOI_PACKED_TO(m)        ((m) & 3)
+
+HANOI_API int hanoiParseMoveIndex(const char *text, HanoiMoveIndex *out);
+HANOI_API char *hanoiFormatMoveIndex(HanoiMoveIndex v, char *out);   // out holds at least 40 bytes
+
+// ═══════════════════════════════════════════════════════════
+//  BATCH-FILL CURSOR
+// ═══════════════════════════════════════════════════════════
+// Pull-style generator for the optimal n-disk solution (A -> C, n <= 127):
+// each call fills the caller's buffer with the next moves. The cursor is a
+// plain struct holding the next move index and the peg of every disk, so
+// it can be copied, stored and resumed anywhere.
+typedef struct {
+    int n;
+    HanoiMoveIndex next;                      // 1-based index of the next move
+    HanoiMoveIndex total;                     // 2^n - 1
+    unsigned char peg[HANOI_MAX_DISKS + 1];   // peg of disk d, d = 1..n
+} HanoiCursor;
+
+HANOI_API int hanoiCursorInit(HanoiCursor *c, int n);                   // 0 when n is out of range
+HANOI_API int hanoiCursorSeek(HanoiCursor *c, HanoiMoveIndex done);     // 0 when done > 2^n - 1
+HANOI_API size_t hanoiCursorFill(HanoiCursor *c, HanoiPackedMove *out, size_t max);   // 0 once finished
+
+// ═══════════════════════════════════════════════════════════
+//  SOLVERS
+// ═══════════════════════════════════════════════════════════
+// Recursive: all state lives in the context
+typedef struct {
+    unsigned long long moves;
+    HanoiPackedMove *out;         // optional: move k is stored at out[k - 1]
+} HanoiContext;
+
+HANOI_API void hanoi(HanoiContext *ctx, int n, char source, char dest, char aux);
+
+// Recursive on a work-stealing pool
+HANOI_API unsigned long long hanoiParallel(int n, int threads, HanoiPackedMove *out);
+
+// Block doubling: copies of a relabelled base block of HANOI_BLOCK_DISKS disks
+#define HANOI_BLOCK_DISKS         12           // 4095-move base block, 8 KB per copy
+#define HANOI_BLOCK_CHUNK_MOVES   (1 << 17)    // 256 KB output chunks for streaming
+
+HANOI_API unsigned long long hanoiBlockGenerate(int n, HanoiPackedMove *out, size_t capacity,
+                                                void (*flush)(const HanoiPackedMove *, size_t, void *),
+                                                void *ctx);
+
+// Baked-in solutions for n <= HANOI_KERNEL_MAX_DISKS
+#define HANOI_KERNEL_MAX_DISKS 16
+
+HANOI_API const HanoiPackedMove *hanoiKernelTable(int n);
+HANOI_API unsigned long long hanoiSolveInto(int n, HanoiPackedMove *out);
+
+// Gray-code generator: move i is computed from i alone, 16 moves per AVX2
+// batch or 8 per SSE4.1 batch, with a scalar fallback (n <= 63)
+HANOI_API size_t hanoiGrayCodeFill(int n, unsigned long long first, HanoiPackedMove *out, size_t count);
+
+// ═══════════════════════════════════════════════════════════
+//  RANDOM ACCESS AND CONFIGURATIONS
+// ═══════════════════════════════════════════════════════════
+// pegOf[1..n] holds the peg of every disk
+HANOI_API HanoiMove hanoiKthMove(int n, unsigned long long k);
+HANOI_API void hanoiStateAfter(int n, unsigned long long k, int *pegOf);
+HANOI_API int hanoiStateIndex(int n, const int *pegOf, unsigned long long *k);
+HANOI_API int hanoiIndexMod3(HanoiMoveIndex k);
+HANOI_API HanoiMove hanoiKthMove128(int n, HanoiMoveIndex k);
+HANOI_API void hanoiStateAfter128(int n, HanoiMoveIndex k, int *pegOf);
+HANOI_API int hanoiStateIndex128(int n, const int *pegOf, HanoiMoveIndex *k);
+
+// Configuration text: one peg letter per disk, smallest disk first
+HANOI_API int hanoiParseConfig(const char *text, int *pegOf, int maxDisks);
+HANOI_API void hanoiFormatConfig(int n, const int *pegOf, char *out);
+
+// Any start -> any target (n <= 63)
+typedef void (*HanoiMoveEmitter)(const HanoiMove *m, void *ctx);
+
+HANOI_API unsigned long long hanoiTowerDistance(int m, const int *pegOf, int peg);
+HANOI_API unsigned long long hanoiDistance(int n, const int *start, const int *target);
+HANOI_API unsigned long long hanoiSolveBetween(int n, const int *start, const int *target,
+                                               HanoiMoveEmitter emit, void *ctx);
+
+// ═══════════════════════════════════════════════════════════
+//  DISTANCE ORACLE
+// ═══════════════════════════════════════════════════════════
+// Batch shortest-path queries, one "START TARGET" pair per line: two
+// configurations of the same length (n <= HANOI_ORACLE_MAX_DISKS) separated by
+// spaces, tabs or a comma. Blank lines are skipped; every other line gets
+// one answer line, in input order (empty in csv, null in json, when the
+// query is malformed).
+#define HANOI_ORACLE_MAX_DISKS    63
+#define HANOI_ORACLE_BLOCK_BYTES  (4 << 20)        // input handled per round
+#define HANOI_ORACLE_INVALID      0xFFFFFFFFFFFFFFFFULL
+
+typedef struct {
+    int threads;
+    unsigned long long queries;       // answered lines, malformed ones included
+    unsigned long long invalid;
+    unsigned long long firstInvalid;  // 1-based input line of the first malformed query, 0 = none
+} HanoiOracleStats;
+
+HANOI_API unsigned long long hanoiDistanceQuery(const char *line, const char *end);   // HANOI_ORACLE_INVALID when malformed
+HANOI_API int hanoiDistanceOracle(FILE *in, FILE *out, int threads, int json, HanoiOracleStats *stats);
+
+// ═══════════════════════════════════════════════════════════
+//  MULTI-PEG (FRAME-STEWART)
+// ═══════════════════════════════════════════════════════════
+#define HANOI_FS_MIN_PEGS   3
+#define HANOI_FS_MAX_PEGS   8
+#define HANOI_FS_MAX_DISKS  64
+#define HANOI_FS_SATURATED  0xFFFFFFFFFFFFFFFFULL   // count does not fit in 64 bits
+
+HANOI_API void hanoiFrameStewartInit();
+HANOI_API unsigned long long hanoiFrameStewartCount(unsigned long long n, int p);
+HANOI_API int hanoiFrameStewartSplit(int n, int p);
+HANOI_API unsigned long long hanoiFrameStewartStream(int n, int p, void (*flush)(const HanoiMove *, int, void *),
+                                                     void *ctx);
+
+// ═══════════════════════════════════════════════════════════
+//  RESTRICTED VARIANTS (ADJACENT-PEG, CYCLIC)
+// ═══════════════════════════════════════════════════════════
+// Adjacent-peg: moves only between neighbouring pegs (A-B, B-C); A -> C
+// takes 3^n - 1 moves. Cyclic: moves only go A -> B -> C -> A; A -> C takes
+// R(n) moves, where Q(n) = 2R(n-1) + 1 is the one-step transfer and
+// R(n) = 2R(n-1) + Q(n-1) + 2. Counts and indices are exact HanoiMoveIndex values.
+#define HANOI_VARIANT_ADJACENT     0
+#define HANOI_VARIANT_CYCLIC       1
+#define HANOI_ADJACENT_MAX_DISKS   80   // 3^80 - 1 < 2^128
+#define HANOI_CYCLIC_MAX_DISKS     88   // R(88) < 2^128
+#define HANOI_VARIANT_MAX_DISKS    HANOI_CYCLIC_MAX_DISKS
+
+typedef struct {
+    unsigned char disks;
+    unsigned char kind;           // 0 = one step (Q), 1 = two steps (R)
+    unsigned char src;
+    unsigned char step;           // next item of the frame's script
+} HanoiVariantFrame;
+
+// Resumable stream with O(n) state, used like HanoiCursor
+typedef struct {
+    int variant;
+    int n;
+    HanoiMoveIndex next;                                    // 1-based index of the next move
+    HanoiMoveIndex total;
+    unsigned char digit[HANOI_VARIANT_MAX_DISKS + 1];       // adjacent: base-3 digits of next - 1
+    unsigned char phase[HANOI_VARIANT_MAX_DISKS + 1];       // adjacent: moves of disk d so far, mod 4
+    int depth;                                              // cyclic: frames in use
+    HanoiVariantFrame frame[HANOI_VARIANT_MAX_DISKS + 1];   // cyclic: explicit recursion stack
+} HanoiVariantStream;
+
+HANOI_API int hanoiVariantMaxDisks(int variant);
+HANOI_API const char *hanoiVariantName(int variant);
+HANOI_API int hanoiParseVariant(const char *text);                   // -1 when unknown
+HANOI_API HanoiMoveIndex hanoiVariantMoveCount(int variant, int n);  // 0 when n is out of range
+HANOI_API HanoiMove hanoiVariantKthMove(int variant, int n, HanoiMoveIndex k);
+HANOI_API int hanoiVariantStreamInit(HanoiVariantStream *s, int variant, int n);
+HANOI_API int hanoiVariantStreamSeek(HanoiVariantStream *s, HanoiMoveIndex done);
+HANOI_API size_t hanoiVariantStreamFill(HanoiVariantStream *s, HanoiPackedMove *out, size_t max);
+
+// ═══════════════════════════════════════════════════════════
+//  STATE-SPACE BREADTH-FIRST SEARCH
+// ═══════════════════════════════════════════════════════════
+#define HANOI_BFS_MAX_DISKS 20
+
+typedef struct {
+    int n;
+    int threads;
+    unsigned long long states;
+    long long levels;          // eccentricity of the start configuration
+    long long targetDistance;
+    double seconds;
+    unsigned long long expanded[HANOI_MAX_THREADS];
+} HanoiBfsResult;
+
+HANOI_API int hanoiBfsExplore(int n, const int *start, const int *target, int threads,
+                              HanoiBfsResult *result, unsigned long long **levelSizes);
+
+// ═══════════════════════════════════════════════════════════
+//  MOVE TRACE FILES
+// ═══════════════════════════════════════════════════════════
+#define HANOI_TRACE_MAGIC        "HTRC"
+#define HANOI_TRACE_VERSION      1
+#define HANOI_TRACE_BLOCK_MOVES  65536
+#define HANOI_TRACE_BUFFER_BYTES (1 << 20)
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t disks;
+    uint32_t blockMoves;
+    uint64_t totalMoves;
+    uint64_t indexOffset;
+    uint64_t startPeg[3];      // bitboard masks (without floor) of the first state
+    uint64_t reserved;
+} HanoiTraceHeader;
+
+typedef struct {
+    uint64_t peg[3];           // state before the first move of the block
+} HanoiTraceIndexEntry;
+
+typedef struct {
+    FILE *file;
+    HanoiTraceHeader header;
+    uint64_t peg[3];           // current state, with the floor bit
+    uint8_t *buffer;
+    size_t used;
+    uint8_t pending;
+    HanoiTraceIndexEntry *index;
+    size_t indexCount;
+    size_t indexCapacity;
+    int failed;                // the index could not grow; reported on close
+} HanoiTraceWriter;
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    const HanoiTraceHeader *header;
+    const uint8_t *data;
+    const HanoiTraceIndexEntry *index;
+    void *file;                // Windows file and mapping handles
+    void *mapping;
+} HanoiTraceReader;
+
+HANOI_API int hanoiTraceWriterOpen(HanoiTraceWriter *w, const char *path, int n, const int *pegOf);
+HANOI_API void hanoiTraceWriterAppend(HanoiTraceWriter *w, int from, int to);
+HANOI_API int hanoiTraceWriterClose(HanoiTraceWriter *w);
+HANOI_API int hanoiTraceReaderOpen(HanoiTraceReader *r, const char *path);
+HANOI_API void hanoiTraceReaderClose(HanoiTraceReader *r);
+HANOI_API uint64_t hanoiTraceReadMoves(const HanoiTraceReader *r, uint64_t first, uint64_t count, HanoiMove *out);
+HANOI_API void hanoiTrace(int n, char source, char dest, char aux, HanoiTraceWriter *w);
+HANOI_API int hanoiIterativeTrace(int n, HanoiTraceWriter *w);       // 0 when out of memory
+
+// ═══════════════════════════════════════════════════════════
+//  MOVE-STREAM VALIDATOR
+// ═══════════════════════════════════════════════════════════
+#define HANOI_VALIDATE_CHUNK_MOVES   (1 << 18)
+#define HANOI_VALIDATE_CHUNKS_PER_THREAD 4
+#define HANOI_VALIDATE_MAX_DISKS     63
+
+typedef struct {
+    const HanoiPackedMove *moves;
+    size_t count;
+    uint64_t start[3];
+    signed char lastPeg[HANOI_VALIDATE_MAX_DISKS + 1];   // -1 = not moved in this chunk
+    size_t badAt;                                        // 1-based offset of the first illegal move
+    const char *reason;
+} HanoiValidateChunk;
+
+typedef struct {
+    int n;
+    int threads;
+    uint64_t peg[3];                  // state before the buffered moves, with floor
+    uint64_t target[3];
+    HanoiPackedMove *buffer;
+    size_t used;
+    size_t capacity;
+    HanoiValidateChunk *chunks;
+    unsigned long long validated;     // moves checked so far
+    unsigned long long firstBad;      // 1-based index of the first illegal move, 0 = none
+    const char *reason;
+} HanoiValidator;
+
+HANOI_API int hanoiValidatorInit(HanoiValidator *v, int n, const int *start, const int *target, int threads);
+HANOI_API void hanoiValidatorPush(HanoiValidator *v, const HanoiPackedMove *moves, size_t count);
+HANOI_API void hanoiValidatorFlush(const HanoiPackedMove *moves, size_t count, void *ctx);
+HANOI_API void hanoiValidatorPushMoves(HanoiValidator *v, const HanoiMove *moves, size_t count);
+HANOI_API int hanoiValidatorFinish(HanoiValidator *v);
+HANOI_API int hanoiValidateText(HanoiValidator *v, FILE *f);
+HANOI_API void hanoiValidateTrace(HanoiValidator *v, const HanoiTraceReader *r);
+
+#endif
@@ -0,0 +1,174 @@
+// hanoi_internal.h - libhanoi plumbing shared by hanoi.c and the bundled
+// client: threads, arenas, peg stacks and the per-engine benchmark hooks.
+// Not installed with the library and not exported from libhanoi.so.
+#ifndef HANOI_INTERNAL_H
+#define HANOI_INTERNAL_H
+
+#include "hanoi.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define THREAD_LOCAL __thread
+
+long long hanoiNowNs();                                  // monotonic clock
+
+// ═══════════════════════════════════════════════════════════
+//  THREADING
+// ═══════════════════════════════════════════════════════════
+typedef void (*WorkerFunction)(int id, void *ctx);
+
+typedef struct {
+    WorkerFunction fn;
+    int id;
+    void *ctx;
+} WorkerStart;
+
+typedef struct {
+    int count;
+    int waiting;
+    unsigned generation;
+    #ifdef _WIN32
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE wake;
+    #else
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    #endif
+} Barrier;
+
+// A single background thread, for helpers that run alongside the caller
+typedef struct {
+    WorkerStart start;
+    #ifdef _WIN32
+    HANDLE handle;
+    #else
+    pthread_t handle;
+    #endif
+} Thread;
+
+int hanoiHardwareThreads();
+void hanoiParallelRun(int threads, WorkerFunction fn, void *ctx);
+void hanoiBarrierInit(Barrier *b, int count);
+void hanoiBarrierDestroy(Barrier *b);
+void hanoiBarrierWait(Barrier *b);
+void hanoiThreadStart(Thread *t, WorkerFunction fn, int id, void *ctx);
+void hanoiThreadJoin(Thread *t);
+void hanoiSleepMs(int ms);
+int hanoiPinToCpu(int cpu);
+int hanoiQuietCpu();
+
+// Counted heap allocation for all library memory
+extern unsigned long long hanoiAllocationCount;
+void *hanoiMalloc(size_t size);
+void *hanoiCalloc(size_t count, size_t size);
+void *hanoiRealloc(void *ptr, size_t size);
+
+// Per-thread bump allocator for engine scratch memory (peg stacks, move
+// chunks). Batch workers install one in hanoiThreadArena; engines take memory
+// from it when present and hand it back with hanoiArenaRelease.
+
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+} Arena;
+
+extern THREAD_LOCAL Arena *hanoiThreadArena;
+
+int hanoiArenaInit(Arena *a, size_t capacity);
+void hanoiArenaFree(Arena *a);
+void *hanoiArenaAlloc(Arena *a, size_t size);
+size_t hanoiArenaMark();
+void hanoiArenaRelease(size_t mark);
+int hanoiArenaOwns(const void *p);
+
+// ═══════════════════════════════════════════════════════════
+//  ENGINE HOOKS
+// ═══════════════════════════════════════════════════════════
+// hanoiSolveX(n) runs one n-disk solve for benchmarking; hanoiVerifyX(n)
+// returns 1 when the engine's output matches the reference. The checksums
+// keep the benchmark output observable.
+
+extern THREAD_LOCAL unsigned long long hanoiCursorChecksum;
+void hanoiSolveCursor(int n);
+int hanoiVerifyCursor(int n);
+
+extern int hanoiParallelThreads;  // 0 = all cores
+int hanoiParallelThreadCount();
+void hanoiSolveParallel(int n);
+
+// Stack pegs
+typedef struct {
+    int *arr;
+    int top;
+} Stack;
+
+Stack hanoiStackCreate(int capacity);         // arr is NULL when out of memory
+Stack hanoiPegStackCreate(int capacity);
+void hanoiPegStackRelease(Stack *s);
+void hanoiStackPush(Stack *s, int value);
+int hanoiStackPop(Stack *s);
+int hanoiStackPeek(Stack *s);
+void hanoiLegalMove(Stack *A, Stack *B, char nameA, char nameB);
+void hanoiLoadStacks(int n, const int *pegOf, Stack pegs[3]);
+void hanoiReadStacks(Stack pegs[3], int *pegOf);
+
+// Bitboards: bit d-1 of a peg mask is disk d, bit 63 is the floor
+#define BITBOARD_FLOOR (1ULL << 63)
+
+typedef struct {
+    uint64_t peg[3];
+} Bitboard;
+
+extern THREAD_LOCAL Bitboard hanoiBitboardResult;
+void hanoiSolveBitboard(int n);
+
+typedef struct {
+    int k;
+    size_t length;                // 2^k - 1
+    HanoiPackedMove *copies[9];   // indexed by src * 3 + dst
+} BlockTable;
+
+extern THREAD_LOCAL unsigned long long hanoiBlockChecksum;
+BlockTable *hanoiBlockTableFor(int k);
+void hanoiSolveBlockDoubling(int n);
+int hanoiVerifyBlockDoubling(int n);
+
+extern THREAD_LOCAL unsigned long long hanoiKernelChecksum;
+int hanoiVerifyKernel(int n);
+void hanoiSolveKernel(int n);
+
+#define SIMD_AUTO    -1
+#define SIMD_SCALAR   0
+#define SIMD_SSE41    1
+#define SIMD_AVX2     2
+
+extern int hanoiSimdPath;         // SIMD_AUTO = best path this CPU supports
+int hanoiSimdPathSupported(int path);
+int hanoiSimdActivePath();
+const char *hanoiSimdPathName(int path);
+int hanoiParseSimdPath(const char *text);          // -2 when unknown
+
+extern THREAD_LOCAL unsigned long long hanoiSimdChecksum;
+void hanoiSolveSimd(int n);
+int hanoiVerifySimd(int n);
+
+extern int hanoiFrameStewartPegs; // peg count used by the framestewart engine
+extern THREAD_LOCAL unsigned long long hanoiFsChecksum;
+void hanoiSolveFrameStewart(int n);
+unsigned long long hanoiFrameStewartEngineMoves(int n);
+int hanoiVerifyFrameStewart(int n);
+
+extern THREAD_LOCAL unsigned long long hanoiVariantChecksum;
+void hanoiSolveAdjacent(int n);
+void hanoiSolveCyclic(int n);
+unsigned long long hanoiAdjacentEngineMoves(int n);   // ~0ULL beyond 64 bits
+unsigned long long hanoiCyclicEngineMoves(int n);
+int hanoiVerifyAdjacent(int n);
+int hanoiVerifyCyclic(int n);
+
+#endif
@@ -1,825 +1,4229 @@
-// hanoi_enhanced.c - Premium User Experience Edition
-#include <stdio.h>
-#include <time.h>
-#include <math.h>
-#include <stdlib.h>
-#include <string.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <conio.h>
-#define CLEAR_SCREEN "cls"
-#else
-#include <unistd.h>
-#define CLEAR_SCREEN "clear"
-#endif
-
-// ═══════════════════════════════════════════════════════════
-//  COLOR DEFINITIONS (ANSI Escape Codes)
-// ═══════════════════════════════════════════════════════════
-#define RESET       "\033[0m"
-#define BOLD        "\033[1m"
-#define DIM         "\033[2m"
-#define UNDERLINE   "\033[4m"
-#define BLINK       "\033[5m"
-
-// Foreground colors
-#define BLACK       "\033[30m"
-#define RED         "\033[31m"
-#define GREEN       "\033[32m"
-#define YELLOW      "\033[33m"
-#define BLUE        "\033[34m"
-#define MAGENTA     "\033[35m"
-#define CYAN        "\033[36m"
-#define WHITE       "\033[37m"
-
-// Bright foreground colors
-#define BRIGHT_BLACK   "\033[90m"
-#define BRIGHT_RED     "\033[91m"
-#define BRIGHT_GREEN   "\033[92m"
-#define BRIGHT_YELLOW  "\033[93m"
-#define BRIGHT_BLUE    "\033[94m"
-#define BRIGHT_MAGENTA "\033[95m"
-#define BRIGHT_CYAN    "\033[96m"
-#define BRIGHT_WHITE   "\033[97m"
-
-// Background colors
-#define BG_BLACK    "\033[40m"
-#define BG_BLUE     "\033[44m"
-#define BG_CYAN     "\033[46m"
-#define BG_GREEN    "\033[42m"
-
-// ═══════════════════════════════════════════════════════════
-//  UTILITY FUNCTIONS
-// ═══════════════════════════════════════════════════════════
-#ifdef _WIN32
-#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
-#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
-#endif
-#endif
-
-void enableVirtualTerminal() {
-    #ifdef _WIN32
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    DWORD dwMode = 0;
-    GetConsoleMode(hOut, &dwMode);
-    dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
-    SetConsoleMode(hOut, dwMode);
-    #endif
-}
-
-void clearScreen() {
-    system(CLEAR_SCREEN);
-}
-
-void printBox(const char* title, const char* color) {
-    int titleLen = strlen(title);
-    int padding = (60 - titleLen) / 2;
-    
-    printf("%s%s+", BOLD, color);
-    for (int i = 0; i < 60; i++) printf("=");
-    printf("+%s\n", RESET);
-    
-    printf("%s%s|", BOLD, color);
-    for (int i = 0; i < padding; i++) printf(" ");
-    printf("%s", title);
-    for (int i = 0; i < 60 - padding - titleLen; i++) printf(" ");
-    printf("|%s\n", RESET);
-    
-    printf("%s%s+", BOLD, color);
-    for (int i = 0; i < 60; i++) printf("=");
-    printf("+%s\n", RESET);
-}
-
-void printSeparator(const char* color) {
-    printf("%s%s", BOLD, color);
-    for (int i = 0; i < 62; i++) printf("-");
-    printf("%s\n", RESET);
-}
-
-void printHeader() {
-    printf("\n");
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s|                   TOWER OF HANOI                           |%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s|           Recursive | Iterative | Visualizer               |%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printf("\n");
-}
-
-void pressAnyKey() {
-    printf("\n%s%s[Press ENTER to continue...]%s", DIM, BRIGHT_BLACK, RESET);
-    getchar();
-    getchar();
-}
-
-void printProgress(int current, int total) {
-    int barWidth = 40;
-    float progress = (float)current / total;
-    int pos = barWidth * progress;
-    
-    printf("\r%s[", BRIGHT_CYAN);
-    for (int i = 0; i < barWidth; i++) {
-        if (i < pos) printf("█");
-        else printf("░");
-    }
-    printf("] %s%.1f%%%s", BRIGHT_YELLOW, progress * 100, RESET);
-    fflush(stdout);
-}
-
-// ═══════════════════════════════════════════════════════════
-//  RECURSIVE IMPLEMENTATION
-// ═══════════════════════════════════════════════════════════
-int moveCount = 0;
-double calibratedMovesPerSecond = 0.0;
-
-void hanoi(int n, char source, char dest, char aux) {
-    if (n == 1) {
-        moveCount++;
-        return;
-    }
-    hanoi(n - 1, source, aux, dest);
-    moveCount++;
-    hanoi(n - 1, aux, dest, source);
-}
-
-void showRecursiveExplanation() {
-    clearScreen();
-    printf("\n");
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
-    printf("%s%s|           RECURSIVE ALGORITHM EXPLAINED                   |%s\n", BOLD, BRIGHT_BLUE, RESET);
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
-    
-    printf("\n%s%s> BASE CASE:%s\n", BOLD, BRIGHT_GREEN, RESET);
-    printf("  When n = 1, simply move the disk from source to destination.\n");
-    
-    printf("\n%s%s> RECURSIVE CASE (n > 1):%s\n", BOLD, BRIGHT_YELLOW, RESET);
-    printf("  %s1.%s Move (n-1) disks from source -> auxiliary (using dest)\n", BRIGHT_CYAN, RESET);
-    printf("  %s2.%s Move the largest disk from source -> destination\n", BRIGHT_CYAN, RESET);
-    printf("  %s3.%s Move (n-1) disks from auxiliary -> destination (using source)\n", BRIGHT_CYAN, RESET);
-    
-    printf("\n%s%s> WHY IT WORKS:%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-    printf("  Each recursive call reduces the problem size by 1 disk,\n");
-    printf("  eventually reaching the base case where moving 1 disk is trivial.\n");
-    
-    printf("\n%s%s> COMPLEXITY ANALYSIS:%s\n", BOLD, BRIGHT_RED, RESET);
-    printf("  %sTime:%s   O(2^n) - Exponential growth, %stotal moves = 2^n - 1%s\n", 
-           BRIGHT_CYAN, RESET, YELLOW, RESET);
-    printf("  %sSpace:%s  O(n) - Stack depth equals number of disks\n", 
-           BRIGHT_CYAN, RESET);
-    
-    printf("\n%s%s> FUN FACTS:%s\n", BOLD, BRIGHT_YELLOW, RESET);
-    printf("  * 64 disks would take %s584 billion years%s at 1 move/second!\n", 
-           BRIGHT_RED, RESET);
-    printf("  * The puzzle has %s18,446,744,073,709,551,615%s total moves for 64 disks\n",
-           BRIGHT_CYAN, RESET);
-    
-    printSeparator(BRIGHT_BLACK);
-    pressAnyKey();
-}
-
-void runRecursiveTest(int disks) {
-    clearScreen();
-    moveCount = 0;
-    
-    printf("\n");
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
-    printf("%s%s|               RECURSIVE TEST - %d DISK%s               |%s\n", 
-           BOLD, BRIGHT_GREEN, disks, disks > 1 ? "S" : " ", RESET);
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
-    printf("\n");
-    
-    // First, calibrate with 25 disks if we haven't already
-    if (calibratedMovesPerSecond == 0.0) {
-        printf("%s%sCalibrating performance with 25 disks...%s\n", BRIGHT_YELLOW, BOLD, RESET);
-        fflush(stdout);
-        
-        moveCount = 0;
-        clock_t calibStart = clock();
-        hanoi(25, 'A', 'C', 'B');
-        clock_t calibEnd = clock();
-        
-        double calibTime = (double)(calibEnd - calibStart) / CLOCKS_PER_SEC;
-        if (calibTime > 0.0001) {
-            calibratedMovesPerSecond = moveCount / calibTime;
-        } else {
-            calibratedMovesPerSecond = 1e9;  // Extremely fast, use a large value
-        }
-        
-        printf("%s%sCalibration complete!%s\n", BRIGHT_GREEN, BOLD, RESET);
-        printf("  Performance: %.0f moves/second\n\n", calibratedMovesPerSecond);
-    }
-    
-    // Now run the actual test
-    moveCount = 0;
-    printf("%s%sComputing %d disks...%s\n", BRIGHT_YELLOW, BOLD, disks, RESET);
-    fflush(stdout);
-    
-    clock_t start = clock();
-    hanoi(disks, 'A', 'C', 'B');
-    clock_t end = clock();
-    
-    double timeSpent = (double)(end - start) / CLOCKS_PER_SEC;
-    
-    // If time is too small to measure accurately, estimate it
-    if (timeSpent < 0.001 && calibratedMovesPerSecond > 0) {
-        timeSpent = moveCount / calibratedMovesPerSecond;
-    }
-    
-    long long expectedMoves = 0;
-    if (disks < 63) expectedMoves = (1LL << disks) - 1;
-    else expectedMoves = (long long)(pow(2.0, (double)disks) - 1.0);
-    
-    printf("\n%s%sRESULTS:%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printSeparator(BRIGHT_BLACK);
-    printf("  %s* Total moves:%s       %s%lld%s\n", 
-           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, expectedMoves, RESET);
-    printf("  %s* Execution time:%s   %s%.9f seconds%s\n", 
-           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, timeSpent, RESET);
-    
-    if ((long long)moveCount == expectedMoves) {
-        printf("  %s* Status:%s           %s%sCORRECT!%s\n", 
-               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_GREEN, RESET);
-    } else {
-        printf("  %s* Status:%s           %s%sERROR!%s\n", 
-               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_RED, RESET);
-    }
-    
-    if (disks >= 15) {
-        double days = (double)expectedMoves / 86400.0;
-        double years = days / 365.25;
-        printf("\n  %sFun Fact:%s At 1 move/second, this would take:\n", 
-               BRIGHT_MAGENTA, RESET);
-        if (years < 1) {
-            printf("     %s%.1f days%s\n", BRIGHT_CYAN, days, RESET);
-        } else if (years < 1000) {
-            printf("     %s%.1f years%s\n", BRIGHT_CYAN, years, RESET);
-        } else {
-            printf("     %s%.2e years%s\n", BRIGHT_CYAN, years, RESET);
-        }
-    }
-    
-    printSeparator(BRIGHT_BLACK);
-    pressAnyKey();
-}
-
-// ═══════════════════════════════════════════════════════════
-//  ITERATIVE IMPLEMENTATION
-// ═══════════════════════════════════════════════════════════
-typedef struct {
-    int *arr;
-    int top;
-} Stack;
-
-Stack createStack(int capacity) {
-    Stack s;
-    s.arr = (int *)malloc(capacity * sizeof(int));
-    s.top = -1;
-    return s;
-}
-
-void push(Stack *s, int value) {
-    s->arr[++(s->top)] = value;
-}
-
-int pop(Stack *s) {
-    if (s->top == -1) return 0;
-    return s->arr[(s->top)--];
-}
-
-int peek(Stack *s) {
-    if (s->top == -1) return 0;
-    return s->arr[s->top];
-}
-
-void legalMoveSilent(Stack *A, Stack *B, char nameA, char nameB) {
-    int topA = peek(A);
-    int topB = peek(B);
-    
-    if (topA == 0) {
-        push(A, pop(B));
-    } else if (topB == 0) {
-        push(B, pop(A));
-    } else if (topA > topB) {
-        push(A, pop(B));
-    } else {
-        push(B, pop(A));
-    }
-}
-
-void showIterativeExplanation() {
-    clearScreen();
-    printf("\n");
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
-    printf("%s%s|          ITERATIVE ALGORITHM EXPLAINED                    |%s\n", BOLD, BRIGHT_BLUE, RESET);
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
-    
-    printf("\n%s%s> CORE CONCEPT:%s\n", BOLD, BRIGHT_GREEN, RESET);
-    printf("  Uses three stacks (A, B, C) to represent the three pegs.\n");
-    printf("  Simulates legal moves in a specific cyclic pattern.\n");
-    
-    printf("\n%s%s> ALGORITHM STEPS:%s\n", BOLD, BRIGHT_YELLOW, RESET);
-    printf("  %s1.%s Calculate total moves = 2^n - 1\n", BRIGHT_CYAN, RESET);
-    printf("  %s2.%s If n is even, swap auxiliary and destination pegs\n", BRIGHT_CYAN, RESET);
-    printf("  %s3.%s For each move i from 1 to total:\n", BRIGHT_CYAN, RESET);
-    printf("      * If i mod 3 = 1: move between source <-> destination\n");
-    printf("      * If i mod 3 = 2: move between source <-> auxiliary\n");
-    printf("      * If i mod 3 = 0: move between auxiliary <-> destination\n");
-    
-    printf("\n%s%s> EVEN/ODD CONSIDERATION:%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-    printf("  For even n, the smallest disk follows a different cycle.\n");
-    printf("  Swapping peg roles at the start ensures correct sequence.\n");
-    
-    printf("\n%s%s> COMPLEXITY ANALYSIS:%s\n", BOLD, BRIGHT_RED, RESET);
-    printf("  %sTime:%s   O(2^n) - Performs 2^n - 1 moves\n", BRIGHT_CYAN, RESET);
-    printf("  %sSpace:%s  O(n) - Three stacks storing n disks\n", BRIGHT_CYAN, RESET);
-    
-    printf("\n%s%s> ADVANTAGES:%s\n", BOLD, BRIGHT_GREEN, RESET);
-    printf("  * No recursion overhead (no stack depth limit)\n");
-    printf("  * More memory efficient for very large n\n");
-    printf("  * Easier to pause/resume execution\n");
-    
-    printSeparator(BRIGHT_BLACK);
-    pressAnyKey();
-}
-
-void runIterativeTest(int n) {
-    clearScreen();
-    printf("\n");
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-    printf("%s%s|               ITERATIVE TEST - %d DISK%s               |%s\n", 
-           BOLD, BRIGHT_MAGENTA, n, n > 1 ? "S" : " ", RESET);
-    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-    printf("\n");
-    
-    // Calibrate if needed
-    if (calibratedMovesPerSecond == 0.0) {
-        printf("%s%sCalibrating performance with 25 disks...%s\n", BRIGHT_YELLOW, BOLD, RESET);
-        fflush(stdout);
-        
-        Stack calibSrc = createStack(25);
-        Stack calibAux = createStack(25);
-        Stack calibDest = createStack(25);
-        
-        for (int i = 25; i >= 1; i--)
-            push(&calibSrc, i);
-        
-        long long calibMoves = (1LL << 25) - 1;
-        char S = 'A', A = 'B', D = 'C';
-        
-        clock_t calibStart = clock();
-        for (long long i = 1; i <= calibMoves; i++) {
-            if (i % 3 == 1) {
-                legalMoveSilent(&calibSrc, &calibDest, S, D);
-            } else if (i % 3 == 2) {
-                legalMoveSilent(&calibSrc, &calibAux, S, A);
-            } else {
-                legalMoveSilent(&calibAux, &calibDest, A, D);
-            }
-        }
-        clock_t calibEnd = clock();
-        
-        double calibTime = (double)(calibEnd - calibStart) / CLOCKS_PER_SEC;
-        if (calibTime > 0.0001) {
-            calibratedMovesPerSecond = calibMoves / calibTime;
-        } else {
-            calibratedMovesPerSecond = 1e9;
-        }
-        
-        free(calibSrc.arr);
-        free(calibAux.arr);
-        free(calibDest.arr);
-        
-        printf("%s%sCalibration complete!%s\n", BRIGHT_GREEN, BOLD, RESET);
-        printf("  Performance: %.0f moves/second\n\n", calibratedMovesPerSecond);
-    }
-    
-    Stack src = createStack(n);
-    Stack aux = createStack(n);
-    Stack dest = createStack(n);
-    
-    for (int i = n; i >= 1; i--)
-        push(&src, i);
-    
-    long long totalMoves = 0;
-    if (n < 63) totalMoves = (1LL << n) - 1;
-    else totalMoves = (long long)(pow(2.0, (double)n) - 1.0);
-    
-    char S = 'A', A = 'B', D = 'C';
-    if (n % 2 == 0) {
-        char temp = D;
-        D = A;
-        A = temp;
-    }
-    
-    printf("%sProcessing %lld moves...%s\n\n", BRIGHT_YELLOW, totalMoves, RESET);
-    
-    clock_t start = clock();
-    
-    for (long long i = 1; i <= totalMoves; i++) {
-        if (i % 3 == 1) {
-            legalMoveSilent(&src, &dest, S, D);
-        } else if (i % 3 == 2) {
-            legalMoveSilent(&src, &aux, S, A);
-        } else {
-            legalMoveSilent(&aux, &dest, A, D);
-        }
-        
-        // Show progress for large computations
-        if (totalMoves > 10000 && i % (totalMoves / 100) == 0) {
-            printProgress(i, totalMoves);
-        }
-    }
-    
-    if (totalMoves > 10000) {
-        printf("\n\n");
-    }
-    
-    clock_t end = clock();
-    double timeTaken = (double)(end - start) / CLOCKS_PER_SEC;
-    
-    // If time is too small to measure accurately, estimate it
-    if (timeTaken < 0.001 && calibratedMovesPerSecond > 0) {
-        timeTaken = totalMoves / calibratedMovesPerSecond;
-    }
-    
-    printf("%s%sRESULTS:%s\n", BOLD, BRIGHT_CYAN, RESET);
-    printSeparator(BRIGHT_BLACK);
-    printf("  %s* Total moves:%s      %s%lld%s\n", 
-           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, totalMoves, RESET);
-    printf("  %s* Execution time:%s  %s%.9f seconds%s\n", 
-           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, timeTaken, RESET);
-    printf("  %s* Status:%s          %s%sCOMPLETE!%s\n", 
-           BRIGHT_YELLOW, RESET, BOLD, BRIGHT_GREEN, RESET);
-    
-    if (n >= 15) {
-        double movesPerSec = totalMoves / timeTaken;
-        printf("  %s* Performance:%s     %s%.0f moves/second%s\n",
-               BRIGHT_YELLOW, RESET, BRIGHT_CYAN, movesPerSec, RESET);
-    }
-    
-    printSeparator(BRIGHT_BLACK);
-    
-    free(src.arr);
-    free(aux.arr);
-    free(dest.arr);
-    
-    pressAnyKey();
-}
-
-// ═══════════════════════════════════════════════════════════
-//  VISUALIZER LAUNCHER
-// ═══════════════════════════════════════════════════════════
-void launchVisualizer() {
-    clearScreen();
-    printf("\n");
-    printBox("LAUNCHING VISUALIZER", BRIGHT_CYAN);
-    printf("\n");
-    
-    #ifdef _WIN32
-    printf("%s  Opening graphical visualizer...%s\n\n", BRIGHT_GREEN, RESET);
-    system("start \"\" \"dist\\run.bat\"");
-    #else
-    printf("%s  Warning: Visualizer is only supported on Windows.%s\n", BRIGHT_RED, RESET);
-    printf("  The console versions work on all platforms!\n");
-    #endif
-    
-    pressAnyKey();
-}
-
-// ═══════════════════════════════════════════════════════════
-//  BATCH TESTING IMPLEMENTATION
-// ═══════════════════════════════════════════════════════════
-void runBatchExperiments(int maxDisks, int isIterative) {
-    clearScreen();
-    printf("\n");
-    const char* modeStr = isIterative ? "ITERATIVE" : "RECURSIVE";
-    const char* color = isIterative ? BRIGHT_MAGENTA : BRIGHT_GREEN;
-    
-    printf("%s%s+=============================================================================+%s\n", BOLD, color, RESET);
-    printf("%s%s|               BATCH PERFORMANCE TEST (%s)                       |%s\n", BOLD, color, modeStr, RESET);
-    printf("%s%s+=============================================================================+%s\n", BOLD, color, RESET);
-    printf("\n");
-    
-    printf("%s%s  %-10s | %-20s | %-15s | %-15s%s\n", BOLD, BRIGHT_CYAN, "Disks", "Total Moves", "Time (sec)", "Moves/Sec", RESET);
-    printSeparator(BRIGHT_BLACK);
-    
-    // Calibrate if needed (reuse existing calibration logic or variable)
-    if (calibratedMovesPerSecond == 0.0) {
-        // Quick calibration
-        clock_t cStart = clock();
-        if (isIterative) {
-             Stack s = createStack(20); Stack a = createStack(20); Stack d = createStack(20);
-             for(int i=20; i>=1; i--) push(&s, i);
-             long long m = (1LL<<20)-1;
-             char S='A', A='B', D='C';
-             for(long long i=1; i<=m; i++) {
-                 if(i%3==1) legalMoveSilent(&s,&d,S,D);
-                 else if(i%3==2) legalMoveSilent(&s,&a,S,A);
-                 else legalMoveSilent(&a,&d,A,D);
-             }
-             free(s.arr); free(a.arr); free(d.arr);
-        } else {
-            moveCount = 0;
-            hanoi(20, 'A', 'C', 'B');
-        }
-        clock_t cEnd = clock();
-        double cTime = (double)(cEnd - cStart) / CLOCKS_PER_SEC;
-        if (cTime > 0) calibratedMovesPerSecond = ((1LL<<20)-1) / cTime;
-        else calibratedMovesPerSecond = 1e9;
-    }
-
-    for (int n = 1; n <= maxDisks; n++) {
-        long long expectedMoves = (1LL << n) - 1;
-        double timeTaken = 0.0;
-        
-        // Run the algorithm
-        clock_t start = clock();
-        
-        if (isIterative) {
-            Stack src = createStack(n);
-            Stack aux = createStack(n);
-            Stack dest = createStack(n);
-            
-            for (int i = n; i >= 1; i--) push(&src, i);
-            
-            char S = 'A', A = 'B', D = 'C';
-            if (n % 2 == 0) { char t = D; D = A; A = t; }
-            
-            for (long long i = 1; i <= expectedMoves; i++) {
-                if (i % 3 == 1) legalMoveSilent(&src, &dest, S, D);
-                else if (i % 3 == 2) legalMoveSilent(&src, &aux, S, A);
-                else legalMoveSilent(&aux, &dest, A, D);
-            }
-            
-            free(src.arr); free(aux.arr); free(dest.arr);
-        } else {
-            moveCount = 0;
-            hanoi(n, 'A', 'C', 'B');
-        }
-        
-        clock_t end = clock();
-        timeTaken = (double)(end - start) / CLOCKS_PER_SEC;
-        
-        // Fix for 0 time on fast machines/small N
-        if (timeTaken < 0.001 && calibratedMovesPerSecond > 0) {
-            timeTaken = expectedMoves / calibratedMovesPerSecond;
-        }
-        
-        double mps = (timeTaken > 0) ? expectedMoves / timeTaken : 0.0;
-        
-        printf("  %-10d | %-20lld | %-15.6f | %-15.0f\n", 
-               n, expectedMoves, timeTaken, mps);
-        fflush(stdout); // Ensure line prints immediately
-    }
-    
-    printSeparator(BRIGHT_BLACK);
-    pressAnyKey();
-}
-
-// ═══════════════════════════════════════════════════════════
-//  MENU SYSTEMS
-// ═══════════════════════════════════════════════════════════
-void recursiveMenu() {
-    int choice;
-    int disks;
-    
-    while (1) {
-        clearScreen();
-        printHeader();
-        
-        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
-        printf("%s%s|                   RECURSIVE MODE                           |%s\n", BOLD, BRIGHT_GREEN, RESET);
-        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
-        printf("\n");
-        
-        printf("  %s1.%s %sCustom Test%s       - Choose any number of disks\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s2.%s %sVisualizer%s        - Launch graphical interface\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s3.%s %sStandard Tests%s    - Run 5, 10, 15, 20 disk tests\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s4.%s %sExplanation%s       - Learn how the algorithm works\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s5.%s %sBatch Test%s        - Run range 1-N (Table View)\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s0.%s %sBack%s              - Return to main menu\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        
-        printf("\n");
-        printSeparator(BRIGHT_BLACK);
-        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
-        
-        if (scanf("%d", &choice) != 1) {
-            while(getchar() != '\n');
-            choice = -1;
-        }
-        
-        switch (choice) {
-            case 1:
-                printf("%s  Number of disks: %s", BRIGHT_YELLOW, RESET);
-                if (scanf("%d", &disks) != 1 || disks <= 0) {
-                    printf("\n%s  Warning: Invalid input! Please enter a positive number.%s\n", 
-                           BRIGHT_RED, RESET);
-                    pressAnyKey();
-                } else if (disks > 30) {
-                    printf("\n%s  Warning: %d disks will take a very long time!%s\n", 
-                           BRIGHT_RED, disks, RESET);
-                    printf("%s     Continue anyway? (1=Yes, 0=No): %s", BRIGHT_YELLOW, RESET);
-                    int confirm;
-                    if (scanf("%d", &confirm) == 1 && confirm == 1) {
-                        runRecursiveTest(disks);
-                    }
-                } else {
-                    runRecursiveTest(disks);
-                }
-                break;
-                
-            case 2:
-                launchVisualizer();
-                break;
-                
-            case 3:
-                runRecursiveTest(5);
-                runRecursiveTest(10);
-                runRecursiveTest(15);
-                runRecursiveTest(20);
-                break;
-                
-            case 4:
-                showRecursiveExplanation();
-                break;
-
-            case 5:
-                printf("%s  Max disks to test (e.g., 25): %s", BRIGHT_YELLOW, RESET);
-                if (scanf("%d", &disks) == 1 && disks > 0) {
-                    if (disks > 30) {
-                         printf("\n%s  Warning: %d disks will take a long time! Continue? (1=Yes): %s", BRIGHT_RED, disks, RESET);
-                         int c; scanf("%d", &c);
-                         if (c!=1) break;
-                    }
-                    runBatchExperiments(disks, 0);
-                }
-                break;
-                
-            case 0:
-                return;
-                
-            default:
-                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
-                       BRIGHT_RED, RESET);
-                pressAnyKey();
-        }
-    }
-}
-
-// ═══════════════════════════════════════════════════════════
-//  ITERATIVE MENU
-// ═══════════════════════════════════════════════════════════
-void iterativeMenu() {
-    int choice;
-    int disks;
-    
-    while (1) {
-        clearScreen();
-        printHeader();
-        
-        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-        printf("%s%s|                   ITERATIVE MODE                           |%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
-        printf("\n");
-        
-        printf("  %s1.%s %sCustom Test%s       - Choose any number of disks\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s3.%s %sStandard Tests%s    - Run 5, 10, 15, 20 disk tests\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s4.%s %sExplanation%s       - Learn how the algorithm works\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s5.%s %sBatch Test%s        - Run range 1-N (Table View)\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s0.%s %sBack%s              - Return to main menu\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        
-        printf("\n");
-        printSeparator(BRIGHT_BLACK);
-        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
-        
-        if (scanf("%d", &choice) != 1) {
-            while(getchar() != '\n');
-            choice = -1;
-        }
-        
-        switch (choice) {
-            case 1:
-                printf("%s  Number of disks: %s", BRIGHT_YELLOW, RESET);
-                if (scanf("%d", &disks) != 1 || disks <= 0) {
-                    printf("\n%s  Warning: Invalid input! Please enter a positive number.%s\n", 
-                           BRIGHT_RED, RESET);
-                    pressAnyKey();
-                } else {
-                    runIterativeTest(disks);
-                }
-                break;
-                
-            case 3:
-                runIterativeTest(5);
-                runIterativeTest(10);
-                runIterativeTest(15);
-                runIterativeTest(20);
-                break;
-                
-            case 4:
-                showIterativeExplanation();
-                break;
-
-            case 5:
-                printf("%s  Max disks to test (e.g., 25): %s", BRIGHT_YELLOW, RESET);
-                if (scanf("%d", &disks) == 1 && disks > 0) {
-                    if (disks > 30) {
-                         printf("\n%s  Warning: %d disks will take a long time! Continue? (1=Yes): %s", BRIGHT_RED, disks, RESET);
-                         int c; scanf("%d", &c);
-                         if (c!=1) break;
-                    }
-                    runBatchExperiments(disks, 1);
-                }
-                break;
-                
-            case 0:
-                return;
-                
-            default:
-                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
-                       BRIGHT_RED, RESET);
-                pressAnyKey();
-        }
-    }
-}
-
-// ═══════════════════════════════════════════════════════════
-//  MAIN FUNCTION
-// ═══════════════════════════════════════════════════════════
-int main() {
-    enableVirtualTerminal();
-    int choice;
-    
-    while (1) {
-        clearScreen();
-        printHeader();
-        
-        printf("  %s1.%s %sRecursive Version%s   - Classic recursive solution\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s2.%s %sIterative Version%s   - Stack-based iterative solution\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s3.%s %sVisualizer%s          - Launch graphical interface\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        printf("  %s0.%s %sExit%s                - Close the program\n", 
-               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
-        
-        printf("\n");
-        printSeparator(BRIGHT_BLACK);
-        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
-        
-        if (scanf("%d", &choice) != 1) {
-            while(getchar() != '\n');
-            choice = -1;
-        }
-        
-        switch (choice) {
-            case 1:
-                recursiveMenu();
-                break;
-                
-            case 2:
-                iterativeMenu();
-                break;
-                
-            case 3:
-                launchVisualizer();
-                break;
-                
-            case 0:
-                clearScreen();
-                printf("\n");
-                printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s|                   Thanks for using!                        |%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s|               Tower of Hanoi Solver v2.0                  |%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
-                printf("\n");
-                return 0;
-                
-            default:
-                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
-                       BRIGHT_RED, RESET);
-                pressAnyKey();
-        }
-    }
-    
-    return 0;
-}
-
-
+// hanoi_enhanced.c - Premium User Experience Edition
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <conio.h>
+#define CLEAR_SCREEN "cls"
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pthread.h>
+#define CLEAR_SCREEN "clear"
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "hanoi_internal.h"
+
+// ═══════════════════════════════════════════════════════════
+//  COLOR DEFINITIONS (ANSI Escape Codes)
+// ═══════════════════════════════════════════════════════════
+#define RESET       "\033[0m"
+#define BOLD        "\033[1m"
+#define DIM         "\033[2m"
+#define UNDERLINE   "\033[4m"
+#define BLINK       "\033[5m"
+
+// Foreground colors
+#define BLACK       "\033[30m"
+#define RED         "\033[31m"
+#define GREEN       "\033[32m"
+#define YELLOW      "\033[33m"
+#define BLUE        "\033[34m"
+#define MAGENTA     "\033[35m"
+#define CYAN        "\033[36m"
+#define WHITE       "\033[37m"
+
+// Bright foreground colors
+#define BRIGHT_BLACK   "\033[90m"
+#define BRIGHT_RED     "\033[91m"
+#define BRIGHT_GREEN   "\033[92m"
+#define BRIGHT_YELLOW  "\033[93m"
+#define BRIGHT_BLUE    "\033[94m"
+#define BRIGHT_MAGENTA "\033[95m"
+#define BRIGHT_CYAN    "\033[96m"
+#define BRIGHT_WHITE   "\033[97m"
+
+// Background colors
+#define BG_BLACK    "\033[40m"
+#define BG_BLUE     "\033[44m"
+#define BG_CYAN     "\033[46m"
+#define BG_GREEN    "\033[42m"
+
+// ═══════════════════════════════════════════════════════════
+//  UTILITY FUNCTIONS
+// ═══════════════════════════════════════════════════════════
+#ifdef _WIN32
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#endif
+
+void enableVirtualTerminal() {
+    #ifdef _WIN32
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD dwMode = 0;
+    GetConsoleMode(hOut, &dwMode);
+    dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+    SetConsoleMode(hOut, dwMode);
+    #endif
+}
+
+void clearScreen() {
+    system(CLEAR_SCREEN);
+}
+
+void printBox(const char* title, const char* color) {
+    int titleLen = strlen(title);
+    int padding = (60 - titleLen) / 2;
+    
+    printf("%s%s+", BOLD, color);
+    for (int i = 0; i < 60; i++) printf("=");
+    printf("+%s\n", RESET);
+    
+    printf("%s%s|", BOLD, color);
+    for (int i = 0; i < padding; i++) printf(" ");
+    printf("%s", title);
+    for (int i = 0; i < 60 - padding - titleLen; i++) printf(" ");
+    printf("|%s\n", RESET);
+    
+    printf("%s%s+", BOLD, color);
+    for (int i = 0; i < 60; i++) printf("=");
+    printf("+%s\n", RESET);
+}
+
+void printSeparator(const char* color) {
+    printf("%s%s", BOLD, color);
+    for (int i = 0; i < 62; i++) printf("-");
+    printf("%s\n", RESET);
+}
+
+void printHeader() {
+    printf("\n");
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s|                   TOWER OF HANOI                           |%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s|           Recursive | Iterative | Visualizer               |%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printf("\n");
+}
+
+void pressAnyKey() {
+    printf("\n%s%s[Press ENTER to continue...]%s", DIM, BRIGHT_BLACK, RESET);
+    getchar();
+    getchar();
+}
+
+int parseIntArg(const char *text, int *out) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || value < 0 || value > 1000000000L) return 0;
+    *out = (int)value;
+    return 1;
+}
+
+int parseULLArg(const char *text, unsigned long long *out) {
+    char *end;
+    if (*text == '\0' || *text == '-') return 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*end != '\0') return 0;
+    *out = value;
+    return 1;
+}
+
+// libhanoi hands back a peg with arr == NULL when memory runs out; the
+// client cannot go on without its pegs
+Stack requireStack(Stack s, int capacity) {
+    if (!s.arr) {
+        fprintf(stderr, "Out of memory allocating a %d-disk peg\n", capacity);
+        exit(1);
+    }
+    return s;
+}
+
+void printProgress(unsigned long long current, unsigned long long total) {
+    int barWidth = 40;
+    double progress = (double)current / total;
+    int pos = barWidth * progress;
+    
+    printf("\r%s[", BRIGHT_CYAN);
+    for (int i = 0; i < barWidth; i++) {
+        if (i < pos) printf("█");
+        else printf("░");
+    }
+    printf("] %s%.1f%%%s", BRIGHT_YELLOW, progress * 100, RESET);
+    fflush(stdout);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  TIMING
+// ═══════════════════════════════════════════════════════════
+#define TIMING_MAX_SAMPLES   1000
+#define TIMING_MIN_SAMPLE_NS 200000LL      // batch solves until one sample lasts 0.2 ms
+#define TIMING_WARMUP_NS     20000000LL    // warm caches and clocks for 20 ms
+#define TIMING_BUDGET_NS     500000000LL   // stop sampling after 0.5 s once stable enough
+#define TIMING_TARGET_RSE    0.01          // relative standard error of the mean to reach
+
+typedef struct {
+    int samples;            // timed samples taken
+    long long innerRuns;    // solves per sample
+    double minNs;           // all statistics are per single solve
+    double medianNs;
+    double p95Ns;
+    double meanNs;
+    double stddevNs;
+    double sampleNs[TIMING_MAX_SAMPLES];
+} TimingStats;
+
+int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Fill min/median/p95/mean/stddev from the first `samples` entries of sampleNs
+void computeTimingStats(TimingStats *stats) {
+    int count = stats->samples;
+    double sorted[TIMING_MAX_SAMPLES];
+    double sum = 0.0;
+    
+    memcpy(sorted, stats->sampleNs, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), compareDoubles);
+    for (int i = 0; i < count; i++) sum += sorted[i];
+    
+    stats->minNs = sorted[0];
+    stats->medianNs = (count % 2) ? sorted[count / 2]
+                                  : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+    stats->p95Ns = sorted[(int)ceil(0.95 * count) - 1];
+    stats->meanNs = sum / count;
+    
+    double var = 0.0;
+    for (int i = 0; i < count; i++) {
+        double d = sorted[i] - stats->meanNs;
+        var += d * d;
+    }
+    stats->stddevNs = (count > 1) ? sqrt(var / (count - 1)) : 0.0;
+}
+
+// Time solve(n) on the monotonic clock: warm up, batch short solves so each
+// sample is well above clock resolution, then keep sampling until at least
+// minSamples are taken and the mean is stable (or the time budget is spent).
+void measureSolve(void (*solve)(int), int n, int minSamples, TimingStats *stats) {
+    if (minSamples < 1) minSamples = 1;
+    if (minSamples > TIMING_MAX_SAMPLES) minSamples = TIMING_MAX_SAMPLES;
+    
+    // Warm-up, also used to size the inner batch
+    long long inner = 1;
+    long long warmStart = hanoiNowNs();
+    while (1) {
+        long long t0 = hanoiNowNs();
+        for (long long r = 0; r < inner; r++) solve(n);
+        long long elapsed = hanoiNowNs() - t0;
+        
+        if (elapsed < TIMING_MIN_SAMPLE_NS) {
+            inner *= 2;
+        } else if (hanoiNowNs() - warmStart >= TIMING_WARMUP_NS || elapsed >= TIMING_WARMUP_NS) {
+            break;
+        }
+    }
+    
+    stats->innerRuns = inner;
+    stats->samples = 0;
+    long long sampleStart = hanoiNowNs();
+    
+    while (stats->samples < TIMING_MAX_SAMPLES) {
+        long long t0 = hanoiNowNs();
+        for (long long r = 0; r < inner; r++) solve(n);
+        long long elapsed = hanoiNowNs() - t0;
+        stats->sampleNs[stats->samples++] = (double)elapsed / inner;
+        
+        if (stats->samples < minSamples) continue;
+        
+        computeTimingStats(stats);
+        double rse = (stats->meanNs > 0)
+            ? stats->stddevNs / sqrt((double)stats->samples) / stats->meanNs : 0.0;
+        if (rse <= TIMING_TARGET_RSE || hanoiNowNs() - sampleStart >= TIMING_BUDGET_NS) break;
+    }
+    
+    computeTimingStats(stats);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  PERFORMANCE COUNTERS AND MEMORY FOOTPRINT
+// ═══════════════════════════════════════════════════════════
+// Optional per-run instrumentation: hardware counters through Linux
+// perf_event_open (user space only, so perf_event_paranoid <= 2 is enough),
+// peak RSS from VmHWM and the number of heap allocations libhanoi makes
+// (hanoiAllocationCount, on every platform). Anything the
+// platform cannot provide is reported as unavailable (negative).
+// Counters are inherited by threads created during the run, so they cover
+// the measuring thread plus the engine's workers (PERF_SCOPE).
+#define PERF_EVENTS 5
+#define PERF_SCOPE  "caller+workers"
+
+typedef struct {
+    double cycles;
+    double instructions;
+    double branchMisses;
+    double l1dMisses;
+    double llcMisses;
+    long peakRssKb;              // whole process, reset before the run
+    double allocations;          // libhanoi heap allocations per solve
+    const char *counterScope;    // PERF_SCOPE, or NULL without counters
+} PerfSample;
+
+int perfEnabled = 0;
+
+#ifdef __linux__
+int perfOpen(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;            // plain (non-group) reads sum the inherited counts
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Peak resident set size in KB, or -1
+long perfPeakRssKb() {
+    FILE *f = fopen("/proc/self/status", "r");
+    char line[256];
+    long kb = -1;
+    
+    if (!f) return -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = strtol(line + 6, NULL, 10);
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+#endif
+
+// Run solve(n) `runs` times under the counters and store per-solve values
+void perfMeasure(void (*solve)(int), int n, long long runs, PerfSample *sample) {
+    double *fields[PERF_EVENTS] = { &sample->cycles, &sample->instructions, &sample->branchMisses,
+                                    &sample->l1dMisses, &sample->llcMisses };
+    for (int e = 0; e < PERF_EVENTS; e++) *fields[e] = -1;
+    sample->peakRssKb = -1;
+    sample->allocations = -1;
+    sample->counterScope = NULL;
+    if (runs < 1) runs = 1;
+    
+    #ifdef __linux__
+    static const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    int fd[PERF_EVENTS] = {
+        perfOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        perfOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        perfOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+        perfOpen(PERF_TYPE_HW_CACHE, l1dReadMiss),
+        perfOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES)
+    };
+    
+    static int warned = 0;
+    if (fd[0] < 0 && !warned) {
+        fprintf(stderr, "Hardware counters unavailable (see /proc/sys/kernel/perf_event_paranoid)\n");
+        warned = 1;
+    }
+    if (fd[0] >= 0) sample->counterScope = PERF_SCOPE;
+    
+    // Writing 5 to clear_refs resets VmHWM to the current RSS
+    FILE *refs = fopen("/proc/self/clear_refs", "w");
+    if (refs) {
+        fputs("5", refs);
+        fclose(refs);
+    }
+    unsigned long long allocStart = __atomic_load_n(&hanoiAllocationCount, __ATOMIC_RELAXED);
+    
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (fd[e] >= 0) ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+    }
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (fd[e] >= 0) ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+    
+    for (long long r = 0; r < runs; r++) solve(n);
+    
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (fd[e] >= 0) ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    sample->allocations = (double)(__atomic_load_n(&hanoiAllocationCount, __ATOMIC_RELAXED) - allocStart) / runs;
+    sample->peakRssKb = perfPeakRssKb();
+    
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        uint64_t value;
+        if (fd[e] < 0) continue;
+        if (read(fd[e], &value, sizeof(value)) == (ssize_t)sizeof(value)) *fields[e] = (double)value / runs;
+        close(fd[e]);
+    }
+    #else
+    unsigned long long allocStart = __atomic_load_n(&hanoiAllocationCount, __ATOMIC_RELAXED);
+    for (long long r = 0; r < runs; r++) solve(n);
+    sample->allocations = (double)(__atomic_load_n(&hanoiAllocationCount, __ATOMIC_RELAXED) - allocStart) / runs;
+    #endif
+}
+
+// ═══════════════════════════════════════════════════════════
+//  PROGRESS TELEMETRY AND CANCELLATION
+// ═══════════════════════════════════════════════════════════
+// A solver publishes how many moves it has made with a relaxed store once
+// per chunk; a reporter thread samples that counter and draws the bar, so
+// the hot loop never divides or prints. Ctrl+C sets solveInterrupted,
+// which solvers poll at the same chunk boundaries.
+#define PROGRESS_TICK_MS      100
+#define PROGRESS_CHUNK_MOVES  (3LL << 16)  // whole rounds of the 3-move cycle
+
+typedef struct {
+    unsigned long long done;       // relaxed, written by the solver
+    unsigned long long total;
+    long long startNs;
+    int stop;
+} ProgressState;
+
+volatile sig_atomic_t solveInterrupted = 0;
+
+void onInterrupt(int sig) {
+    (void)sig;
+    solveInterrupted = 1;
+}
+
+void progressReporter(int id, void *arg) {
+    ProgressState *p = (ProgressState *)arg;
+    (void)id;
+    
+    while (!__atomic_load_n(&p->stop, __ATOMIC_ACQUIRE)) {
+        hanoiSleepMs(PROGRESS_TICK_MS);
+        unsigned long long done = __atomic_load_n(&p->done, __ATOMIC_RELAXED);
+        double elapsed = (hanoiNowNs() - p->startNs) / 1e9;
+        double rate = (elapsed > 0) ? done / elapsed : 0.0;
+        double eta = (rate > 0) ? (p->total - done) / rate : 0.0;
+        
+        printProgress(done, p->total);
+        printf("  %s%.3g moves/s  ETA %.1f s%s   ", BRIGHT_BLACK, rate, eta, RESET);
+        fflush(stdout);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+//  INTERACTIVE TESTS
+// ═══════════════════════════════════════════════════════════
+void showRecursiveExplanation() {
+    clearScreen();
+    printf("\n");
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
+    printf("%s%s|           RECURSIVE ALGORITHM EXPLAINED                   |%s\n", BOLD, BRIGHT_BLUE, RESET);
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
+    
+    printf("\n%s%s> BASE CASE:%s\n", BOLD, BRIGHT_GREEN, RESET);
+    printf("  When n = 1, simply move the disk from source to destination.\n");
+    
+    printf("\n%s%s> RECURSIVE CASE (n > 1):%s\n", BOLD, BRIGHT_YELLOW, RESET);
+    printf("  %s1.%s Move (n-1) disks from source -> auxiliary (using dest)\n", BRIGHT_CYAN, RESET);
+    printf("  %s2.%s Move the largest disk from source -> destination\n", BRIGHT_CYAN, RESET);
+    printf("  %s3.%s Move (n-1) disks from auxiliary -> destination (using source)\n", BRIGHT_CYAN, RESET);
+    
+    printf("\n%s%s> WHY IT WORKS:%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+    printf("  Each recursive call reduces the problem size by 1 disk,\n");
+    printf("  eventually reaching the base case where moving 1 disk is trivial.\n");
+    
+    printf("\n%s%s> COMPLEXITY ANALYSIS:%s\n", BOLD, BRIGHT_RED, RESET);
+    printf("  %sTime:%s   O(2^n) - Exponential growth, %stotal moves = 2^n - 1%s\n", 
+           BRIGHT_CYAN, RESET, YELLOW, RESET);
+    printf("  %sSpace:%s  O(n) - Stack depth equals number of disks\n", 
+           BRIGHT_CYAN, RESET);
+    
+    printf("\n%s%s> FUN FACTS:%s\n", BOLD, BRIGHT_YELLOW, RESET);
+    printf("  * 64 disks would take %s584 billion years%s at 1 move/second!\n", 
+           BRIGHT_RED, RESET);
+    printf("  * The puzzle has %s18,446,744,073,709,551,615%s total moves for 64 disks\n",
+           BRIGHT_CYAN, RESET);
+    
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+void runRecursiveTest(int disks) {
+    HanoiContext ctx = { 0, NULL };
+    char movesText[40];
+    clearScreen();
+    
+    printf("\n");
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
+    printf("%s%s|               RECURSIVE TEST - %d DISK%s               |%s\n", 
+           BOLD, BRIGHT_GREEN, disks, disks > 1 ? "S" : " ", RESET);
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
+    printf("\n");
+    
+    // HanoiContext counts moves in 64 bits
+    if (disks > 63) {
+        printf("%s  Warning: the recursive test supports up to 63 disks; run a move range\n"
+               "  of a larger tower with --range N A B.%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    printf("%s%sComputing %d disks...%s\n", BRIGHT_YELLOW, BOLD, disks, RESET);
+    fflush(stdout);
+    
+    long long start = hanoiNowNs();
+    hanoi(&ctx, disks, 'A', 'C', 'B');
+    long long end = hanoiNowNs();
+    
+    double timeSpent = (end - start) / 1e9;
+    
+    HanoiMoveIndex expectedMoves = ((HanoiMoveIndex)1 << disks) - 1;
+    
+    printf("\n%s%sRESULTS:%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printSeparator(BRIGHT_BLACK);
+    printf("  %s* Total moves:%s       %s%s%s\n", 
+           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, hanoiFormatMoveIndex(expectedMoves, movesText), RESET);
+    printf("  %s* Execution time:%s   %s%.9f seconds%s\n", 
+           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, timeSpent, RESET);
+    
+    if ((HanoiMoveIndex)ctx.moves == expectedMoves) {
+        printf("  %s* Status:%s           %s%sCORRECT!%s\n", 
+               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_GREEN, RESET);
+    } else {
+        printf("  %s* Status:%s           %s%sERROR!%s\n", 
+               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_RED, RESET);
+    }
+    
+    if (disks >= 15) {
+        double days = (double)expectedMoves / 86400.0;
+        double years = days / 365.25;
+        printf("\n  %sFun Fact:%s At 1 move/second, this would take:\n", 
+               BRIGHT_MAGENTA, RESET);
+        if (years < 1) {
+            printf("     %s%.1f days%s\n", BRIGHT_CYAN, days, RESET);
+        } else if (years < 1000) {
+            printf("     %s%.1f years%s\n", BRIGHT_CYAN, years, RESET);
+        } else {
+            printf("     %s%.2e years%s\n", BRIGHT_CYAN, years, RESET);
+        }
+    }
+    
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+void showIterativeExplanation() {
+    clearScreen();
+    printf("\n");
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
+    printf("%s%s|          ITERATIVE ALGORITHM EXPLAINED                    |%s\n", BOLD, BRIGHT_BLUE, RESET);
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_BLUE, RESET);
+    
+    printf("\n%s%s> CORE CONCEPT:%s\n", BOLD, BRIGHT_GREEN, RESET);
+    printf("  Uses three stacks (A, B, C) to represent the three pegs.\n");
+    printf("  Simulates legal moves in a specific cyclic pattern.\n");
+    
+    printf("\n%s%s> ALGORITHM STEPS:%s\n", BOLD, BRIGHT_YELLOW, RESET);
+    printf("  %s1.%s Calculate total moves = 2^n - 1\n", BRIGHT_CYAN, RESET);
+    printf("  %s2.%s If n is even, swap auxiliary and destination pegs\n", BRIGHT_CYAN, RESET);
+    printf("  %s3.%s For each move i from 1 to total:\n", BRIGHT_CYAN, RESET);
+    printf("      * If i mod 3 = 1: move between source <-> destination\n");
+    printf("      * If i mod 3 = 2: move between source <-> auxiliary\n");
+    printf("      * If i mod 3 = 0: move between auxiliary <-> destination\n");
+    
+    printf("\n%s%s> EVEN/ODD CONSIDERATION:%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+    printf("  For even n, the smallest disk follows a different cycle.\n");
+    printf("  Swapping peg roles at the start ensures correct sequence.\n");
+    
+    printf("\n%s%s> COMPLEXITY ANALYSIS:%s\n", BOLD, BRIGHT_RED, RESET);
+    printf("  %sTime:%s   O(2^n) - Performs 2^n - 1 moves\n", BRIGHT_CYAN, RESET);
+    printf("  %sSpace:%s  O(n) - Three stacks storing n disks\n", BRIGHT_CYAN, RESET);
+    
+    printf("\n%s%s> ADVANTAGES:%s\n", BOLD, BRIGHT_GREEN, RESET);
+    printf("  * No recursion overhead (no stack depth limit)\n");
+    printf("  * More memory efficient for very large n\n");
+    printf("  * Easier to pause/resume execution\n");
+    
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+void printPegs(int n, const int *pegOf) {
+    for (int p = 0; p < 3; p++) {
+        printf("  %s%c:%s", BRIGHT_CYAN, 'A' + p, RESET);
+        for (int d = n; d >= 1; d--) {
+            if (pegOf[d] == p) printf(" %d", d);
+        }
+        printf("\n");
+    }
+}
+
+void runSeekMove() {
+    int n;
+    unsigned long long k;
+    
+    printf("%s  Number of disks (1-63): %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%d", &n) != 1 || n < 1 || n > 63) {
+        printf("\n%s  Warning: Invalid input! Please enter 1 to 63 disks.%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    unsigned long long totalMoves = (1ULL << n) - 1;
+    printf("%s  Move number (1-%llu): %s", BRIGHT_YELLOW, totalMoves, RESET);
+    if (scanf("%llu", &k) != 1 || k < 1 || k > totalMoves) {
+        printf("\n%s  Warning: Move number out of range!%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    long long start = hanoiNowNs();
+    HanoiMove m = hanoiKthMove(n, k);
+    long long end = hanoiNowNs();
+    
+    printf("\n%s%sMOVE %llu OF %llu:%s\n", BOLD, BRIGHT_CYAN, k, totalMoves, RESET);
+    printSeparator(BRIGHT_BLACK);
+    printf("  %s* Disk:%s            %s%d%s\n", BRIGHT_YELLOW, RESET, BRIGHT_WHITE, m.disk, RESET);
+    printf("  %s* From -> To:%s      %s%c -> %c%s\n", BRIGHT_YELLOW, RESET, BRIGHT_WHITE,
+           'A' + m.from, 'A' + m.to, RESET);
+    printf("  %s* Lookup time:%s     %s%lld ns%s\n", BRIGHT_YELLOW, RESET, BRIGHT_WHITE, end - start, RESET);
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+void runJumpToState() {
+    int n;
+    unsigned long long k;
+    int pegOf[64];
+    
+    printf("%s  Number of disks (1-63): %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%d", &n) != 1 || n < 1 || n > 63) {
+        printf("\n%s  Warning: Invalid input! Please enter 1 to 63 disks.%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    unsigned long long totalMoves = (1ULL << n) - 1;
+    printf("%s  Moves already played (0-%llu): %s", BRIGHT_YELLOW, totalMoves, RESET);
+    if (scanf("%llu", &k) != 1 || k > totalMoves) {
+        printf("\n%s  Warning: Move count out of range!%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    long long start = hanoiNowNs();
+    hanoiStateAfter(n, k, pegOf);
+    long long end = hanoiNowNs();
+    
+    unsigned long long back = 0;
+    int onPath = hanoiStateIndex(n, pegOf, &back);
+    
+    printf("\n%s%sSTATE AFTER %llu MOVES:%s\n", BOLD, BRIGHT_CYAN, k, RESET);
+    printSeparator(BRIGHT_BLACK);
+    printPegs(n, pegOf);
+    printf("\n  %s* Computed in:%s      %s%lld ns%s\n", BRIGHT_YELLOW, RESET, BRIGHT_WHITE, end - start, RESET);
+    printf("  %s* Rank check:%s       %s%s%s\n", BRIGHT_YELLOW, RESET, BOLD,
+           (onPath && back == k) ? BRIGHT_GREEN "CORRECT!" : BRIGHT_RED "ERROR!", RESET);
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+void printMoveLine(const HanoiMove *m, void *ctx) {
+    int *step = (int *)ctx;
+    printf("  %s%4d.%s disk %s%d%s: %c -> %c\n", BRIGHT_BLACK, ++(*step), RESET,
+           BRIGHT_WHITE, m->disk, RESET, 'A' + m->from, 'A' + m->to);
+}
+
+void runSolveBetween() {
+    char startText[64], targetText[64];
+    int start[64], target[64];
+    
+    printf("%s  Start configuration (e.g. ABCA, smallest disk first): %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%63s", startText) != 1) return;
+    printf("%s  Target configuration: %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%63s", targetText) != 1) return;
+    
+    int n = hanoiParseConfig(startText, start, 63);
+    if (n < 0 || hanoiParseConfig(targetText, target, 63) != n) {
+        printf("\n%s  Warning: Both configurations need the same number of A/B/C letters!%s\n",
+               BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    unsigned long long length = hanoiSolveBetween(n, start, target, NULL, NULL);
+    
+    printf("\n%s%sSHORTEST SOLUTION:%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printSeparator(BRIGHT_BLACK);
+    printf("  %s* Total moves:%s      %s%llu%s\n\n", BRIGHT_YELLOW, RESET, BRIGHT_WHITE, length, RESET);
+    
+    if (length <= 256) {
+        int step = 0;
+        hanoiSolveBetween(n, start, target, printMoveLine, &step);
+    } else {
+        printf("  %s(too many moves to list, use --solve for the full stream)%s\n", DIM, RESET);
+    }
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+// ═══════════════════════════════════════════════════════════
+//  LONG ITERATIVE RUNS (PROGRESS, CHECKPOINTS)
+// ═══════════════════════════════════════════════════════════
+// A long iterative solve can save its move index, elapsed time and peg
+// configuration to a small text file, written to FILE.tmp and renamed over
+// FILE so a crash never leaves a torn checkpoint:
+//   hanoi-checkpoint 1
+//   disks 40
+//   moves 123456789
+//   elapsed_ns 4567890123
+//   pegs CCBAA...          (one peg letter per disk, smallest first)
+// On resume the configuration must be the one hanoiStateAfter() gives for
+// that move index, so a stale or edited file is rejected.
+#define CHECKPOINT_INTERVAL_NS 30000000000LL   // 30 s
+#define CHECKPOINT_MAX_DISKS   62
+
+typedef struct {
+    int n;
+    long long total;
+    long long done;              // moves made, including before a resume
+    long long resumedFrom;       // 0 for a fresh run
+    double seconds;              // including time spent before a resume
+    int interrupted;
+    int checkpoints;             // written by this session
+    int finalStateOk;            // pegs match hanoiStateAfter(n, done)
+} IterativeRun;
+
+void defaultCheckpointPath(int n, char *out, size_t size) {
+    snprintf(out, size, "hanoi-%d.ckpt", n);
+}
+
+int checkpointWrite(const char *path, int n, long long done, long long elapsedNs, Stack pegs[3]) {
+    int pegOf[CHECKPOINT_MAX_DISKS + 1];
+    char config[CHECKPOINT_MAX_DISKS + 1];
+    char tmpPath[1024];
+    
+    hanoiReadStacks(pegs, pegOf);
+    hanoiFormatConfig(n, pegOf, config);
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    
+    FILE *f = fopen(tmpPath, "w");
+    if (!f) return 0;
+    fprintf(f, "hanoi-checkpoint 1\ndisks %d\nmoves %lld\nelapsed_ns %lld\npegs %s\n",
+            n, done, elapsedNs, config);
+    int ok = fflush(f) == 0;
+    #ifndef _WIN32
+    ok = ok && fsync(fileno(f)) == 0;
+    #endif
+    ok = (fclose(f) == 0) && ok;
+    
+    #ifdef _WIN32
+    ok = ok && MoveFileExA(tmpPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    #else
+    ok = ok && rename(tmpPath, path) == 0;
+    #endif
+    if (!ok) remove(tmpPath);
+    return ok;
+}
+
+// 1 when path holds a valid checkpoint for n disks, 0 when it does not
+// exist, -1 (with a message on stderr) when it is malformed or inconsistent
+int checkpointRead(const char *path, int n, long long *done, long long *elapsedNs, int *pegOf) {
+    FILE *f = fopen(path, "r");
+    int version, disks;
+    char config[CHECKPOINT_MAX_DISKS + 2];
+    
+    if (!f) return 0;
+    int fields = fscanf(f, "hanoi-checkpoint %d disks %d moves %lld elapsed_ns %lld pegs %63s",
+                        &version, &disks, done, elapsedNs, config);
+    fclose(f);
+    
+    if (fields != 5 || version != 1) {
+        fprintf(stderr, "%s: not a checkpoint file\n", path);
+        return -1;
+    }
+    if (disks != n) {
+        fprintf(stderr, "%s: checkpoint is for %d disks, not %d\n", path, disks, n);
+        return -1;
+    }
+    if (*done < 0 || *done > (1LL << n) - 1 || *elapsedNs < 0 || hanoiParseConfig(config, pegOf, n) != n) {
+        fprintf(stderr, "%s: checkpoint values out of range\n", path);
+        return -1;
+    }
+    
+    int expected[CHECKPOINT_MAX_DISKS + 1];
+    hanoiStateAfter(n, (unsigned long long)*done, expected);
+    for (int d = 1; d <= n; d++) {
+        if (expected[d] != pegOf[d]) {
+            fprintf(stderr, "%s: pegs do not match move %lld of the solution\n", path, *done);
+            return -1;
+        }
+    }
+    return 1;
+}
+
+// Iterative solve of n <= CHECKPOINT_MAX_DISKS disks with the progress
+// reporter (when report is set), Ctrl+C handling and, when checkpointPath
+// is set, a checkpoint every CHECKPOINT_INTERVAL_NS and on interruption.
+// The checkpoint is deleted once the run completes. Returns 0, or -1 when
+// resume was requested and the checkpoint is unusable.
+int iterativeRun(int n, const char *checkpointPath, int resume, int report, IterativeRun *run) {
+    Stack src = requireStack(hanoiStackCreate(n), n);
+    Stack aux = requireStack(hanoiStackCreate(n), n);
+    Stack dest = requireStack(hanoiStackCreate(n), n);
+    long long previousNs = 0;
+    
+    memset(run, 0, sizeof(*run));
+    run->n = n;
+    run->total = (1LL << n) - 1;
+    
+    char S = 'A', A = 'B', D = 'C';
+    if (n % 2 == 0) {
+        char temp = D;
+        D = A;
+        A = temp;
+    }
+    // The stacks in peg order A, B, C, as the random-access helpers expect
+    Stack *byPeg[3];
+    byPeg[S - 'A'] = &src;
+    byPeg[A - 'A'] = &aux;
+    byPeg[D - 'A'] = &dest;
+    Stack pegs[3];
+    
+    if (resume) {
+        int pegOf[CHECKPOINT_MAX_DISKS + 1];
+        int status = checkpointPath ? checkpointRead(checkpointPath, n, &run->done, &previousNs, pegOf) : 0;
+        if (status != 1) {
+            if (status == 0) fprintf(stderr, "No checkpoint to resume at %s\n", checkpointPath ? checkpointPath : "(none)");
+            free(src.arr);
+            free(aux.arr);
+            free(dest.arr);
+            return -1;
+        }
+        for (int p = 0; p < 3; p++) pegs[p] = *byPeg[p];
+        hanoiLoadStacks(n, pegOf, pegs);
+        for (int p = 0; p < 3; p++) *byPeg[p] = pegs[p];
+        run->resumedFrom = run->done;
+    } else {
+        for (int i = n; i >= 1; i--)
+            hanoiStackPush(&src, i);
+    }
+    
+    long long done = run->done;
+    ProgressState progress = { (unsigned long long)done, (unsigned long long)run->total, 0, 0 };
+    Thread reporter;
+    
+    solveInterrupted = 0;
+    void (*previousHandler)(int) = signal(SIGINT, onInterrupt);
+    
+    long long start = hanoiNowNs();
+    long long lastCheckpoint = start;
+    progress.startNs = start;
+    if (report) hanoiThreadStart(&reporter, progressReporter, 1, &progress);
+    
+    // A resumed run may stop mid-cycle; finish that cycle move by move
+    while (done % 3 != 0 && done < run->total) {
+        if (done % 3 == 1) hanoiLegalMove(&src, &aux, S, A);
+        else hanoiLegalMove(&aux, &dest, A, D);
+        done++;
+    }
+    
+    // Whole rounds of the three-move cycle per chunk; progress, Ctrl+C and
+    // checkpoints are only looked at between chunks
+    while (done < run->total && !solveInterrupted) {
+        long long chunk = run->total - done;
+        if (chunk > PROGRESS_CHUNK_MOVES) chunk = PROGRESS_CHUNK_MOVES;
+        
+        for (long long r = chunk / 3; r > 0; r--) {
+            hanoiLegalMove(&src, &dest, S, D);
+            hanoiLegalMove(&src, &aux, S, A);
+            hanoiLegalMove(&aux, &dest, A, D);
+        }
+        if (chunk % 3 >= 1) hanoiLegalMove(&src, &dest, S, D);
+        if (chunk % 3 == 2) hanoiLegalMove(&src, &aux, S, A);
+        
+        done += chunk;
+        __atomic_store_n(&progress.done, (unsigned long long)done, __ATOMIC_RELAXED);
+        
+        if (checkpointPath && done < run->total) {
+            long long now = hanoiNowNs();
+            if (now - lastCheckpoint >= CHECKPOINT_INTERVAL_NS) {
+                for (int p = 0; p < 3; p++) pegs[p] = *byPeg[p];
+                run->checkpoints += checkpointWrite(checkpointPath, n, done, previousNs + now - start, pegs);
+                lastCheckpoint = now;
+            }
+        }
+    }
+    
+    long long end = hanoiNowNs();
+    signal(SIGINT, previousHandler);
+    if (report) {
+        __atomic_store_n(&progress.stop, 1, __ATOMIC_RELEASE);
+        hanoiThreadJoin(&reporter);
+        printProgress(done, run->total);
+        printf("\n\n");
+    }
+    
+    run->done = done;
+    run->seconds = (previousNs + end - start) / 1e9;
+    run->interrupted = done < run->total;
+    
+    int pegOf[CHECKPOINT_MAX_DISKS + 1], expected[CHECKPOINT_MAX_DISKS + 1];
+    for (int p = 0; p < 3; p++) pegs[p] = *byPeg[p];
+    hanoiReadStacks(pegs, pegOf);
+    hanoiStateAfter(n, (unsigned long long)done, expected);
+    run->finalStateOk = memcmp(pegOf + 1, expected + 1, n * sizeof(int)) == 0;
+    
+    if (checkpointPath) {
+        if (run->interrupted) {
+            run->checkpoints += checkpointWrite(checkpointPath, n, done, previousNs + end - start, pegs);
+        } else {
+            remove(checkpointPath);
+        }
+    }
+    
+    free(src.arr);
+    free(aux.arr);
+    free(dest.arr);
+    return 0;
+}
+
+// Stack-engine execution of moves a+1 .. b only (the half-open range [a, b)
+// of 0-based move positions) of an n-disk puzzle, n <= HANOI_MAX_DISKS,
+// starting from the configuration after move a. Ranges of one huge puzzle
+// can be sampled, benchmarked or split into shards across processes.
+typedef struct {
+    int n;
+    HanoiMoveIndex first;        // a
+    HanoiMoveIndex last;         // b
+    HanoiMoveIndex done;         // moves made, b - a unless interrupted
+    double seconds;
+    int interrupted;
+    int finalStateOk;            // pegs match hanoiStateAfter128(n, a + done)
+    char config[HANOI_MAX_DISKS + 1];
+} RangeRun;
+
+int hanoiRunRange(int n, HanoiMoveIndex a, HanoiMoveIndex b, RangeRun *run) {
+    int pegOf[HANOI_MAX_DISKS + 1], expected[HANOI_MAX_DISKS + 1] = { 0 };
+    Stack pegs[3];
+    
+    memset(run, 0, sizeof(*run));
+    run->n = n;
+    run->first = a;
+    run->last = b;
+    
+    for (int p = 0; p < 3; p++) pegs[p] = requireStack(hanoiStackCreate(n), n);
+    hanoiStateAfter128(n, a, pegOf);
+    hanoiLoadStacks(n, pegOf, pegs);
+    
+    // Same three-move cycle as the iterative engine, on pegs indexed A, B, C
+    int S = 0, A = 1, D = 2;
+    if (n % 2 == 0) {
+        A = 2;
+        D = 1;
+    }
+    Stack *src = &pegs[S], *aux = &pegs[A], *dest = &pegs[D];
+    char cS = 'A' + S, cA = 'A' + A, cD = 'A' + D;
+    
+    solveInterrupted = 0;
+    void (*previousHandler)(int) = signal(SIGINT, onInterrupt);
+    long long start = hanoiNowNs();
+    
+    HanoiMoveIndex next = a + 1;  // 1-based index of the next move
+    while (next <= b && hanoiIndexMod3(next) != 1) {
+        if (hanoiIndexMod3(next) == 2) hanoiLegalMove(src, aux, cS, cA);
+        else hanoiLegalMove(aux, dest, cA, cD);
+        next++;
+    }
+    while (next <= b && !solveInterrupted) {
+        HanoiMoveIndex remaining = b - next + 1;
+        long long chunk = remaining > (HanoiMoveIndex)PROGRESS_CHUNK_MOVES ? PROGRESS_CHUNK_MOVES : (long long)remaining;
+        
+        for (long long r = chunk / 3; r > 0; r--) {
+            hanoiLegalMove(src, dest, cS, cD);
+            hanoiLegalMove(src, aux, cS, cA);
+            hanoiLegalMove(aux, dest, cA, cD);
+        }
+        if (chunk % 3 >= 1) hanoiLegalMove(src, dest, cS, cD);
+        if (chunk % 3 == 2) hanoiLegalMove(src, aux, cS, cA);
+        next += chunk;
+    }
+    
+    run->seconds = (hanoiNowNs() - start) / 1e9;
+    signal(SIGINT, previousHandler);
+    
+    run->done = next - 1 - a;
+    run->interrupted = next <= b;
+    hanoiReadStacks(pegs, pegOf);
+    hanoiStateAfter128(n, next - 1, expected);
+    run->finalStateOk = memcmp(pegOf + 1, expected + 1, n * sizeof(int)) == 0;
+    hanoiFormatConfig(n, pegOf, run->config);
+    
+    for (int p = 0; p < 3; p++) free(pegs[p].arr);
+    return run->finalStateOk;
+}
+
+void runIterativeTest(int n, int resume) {
+    char checkpointPath[64];
+    IterativeRun run;
+    
+    clearScreen();
+    printf("\n");
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+    printf("%s%s|               ITERATIVE TEST - %d DISK%s               |%s\n", 
+           BOLD, BRIGHT_MAGENTA, n, n > 1 ? "S" : " ", RESET);
+    printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+    printf("\n");
+    
+    if (n > CHECKPOINT_MAX_DISKS) {
+        printf("%s  Warning: the iterative test supports up to %d disks; run a move range\n"
+               "  of a larger tower with --range N A B.%s\n",
+               BRIGHT_RED, CHECKPOINT_MAX_DISKS, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    defaultCheckpointPath(n, checkpointPath, sizeof(checkpointPath));
+    long long totalMoves = (1LL << n) - 1;
+    printf("%sProcessing %lld moves... (Ctrl+C to stop)%s\n\n", BRIGHT_YELLOW, totalMoves, RESET);
+    
+    if (iterativeRun(n, checkpointPath, resume, totalMoves > 10000, &run) != 0) {
+        pressAnyKey();
+        return;
+    }
+    
+    printf("%s%sRESULTS:%s\n", BOLD, BRIGHT_CYAN, RESET);
+    printSeparator(BRIGHT_BLACK);
+    if (run.resumedFrom) {
+        printf("  %s* Resumed at move:%s %s%lld%s\n", 
+               BRIGHT_YELLOW, RESET, BRIGHT_WHITE, run.resumedFrom, RESET);
+    }
+    if (run.interrupted) {
+        printf("  %s* Moves made:%s       %s%lld of %lld (%.2f%%)%s\n", 
+               BRIGHT_YELLOW, RESET, BRIGHT_WHITE, run.done, totalMoves, 100.0 * run.done / totalMoves, RESET);
+    } else {
+        printf("  %s* Total moves:%s      %s%lld%s\n", 
+               BRIGHT_YELLOW, RESET, BRIGHT_WHITE, totalMoves, RESET);
+    }
+    printf("  %s* Execution time:%s  %s%.9f seconds%s\n", 
+           BRIGHT_YELLOW, RESET, BRIGHT_WHITE, run.seconds, RESET);
+    if (!run.finalStateOk) {
+        printf("  %s* Status:%s          %s%sERROR!%s\n", 
+               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_RED, RESET);
+    } else if (run.interrupted) {
+        printf("  %s* Status:%s          %s%sINTERRUPTED%s\n", 
+               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_RED, RESET);
+        if (run.checkpoints) {
+            printf("  %s* Checkpoint:%s      %s%s (use Resume Run to continue)%s\n", 
+                   BRIGHT_YELLOW, RESET, BRIGHT_WHITE, checkpointPath, RESET);
+        }
+    } else {
+        printf("  %s* Status:%s          %s%sCOMPLETE!%s\n", 
+               BRIGHT_YELLOW, RESET, BOLD, BRIGHT_GREEN, RESET);
+    }
+    
+    if (n >= 15 && run.seconds > 0) {
+        double movesPerSec = run.done / run.seconds;
+        printf("  %s* Performance:%s     %s%.0f moves/second%s\n",
+               BRIGHT_YELLOW, RESET, BRIGHT_CYAN, movesPerSec, RESET);
+    }
+    
+    printSeparator(BRIGHT_BLACK);
+    pressAnyKey();
+}
+
+// ═══════════════════════════════════════════════════════════
+//  VISUALIZER SERVER (POSIX)
+// ═══════════════════════════════════════════════════════════
+// Serves the visualizer bundle from dist/ and streams moves from the native
+// engines, so no Node tooling is needed and the browser never has to build
+// the whole sequence:
+//   GET /api/moves?n=25&start=1&count=1000[&format=bin]
+//       moves start..start+count-1 as JSON [disk,from,to,...] triples, or
+//       with format=bin as little-endian uint16 (disk << 4 | from << 2 | to)
+//   GET /api/state?n=25&k=1000
+//       pegs after k moves, bottom disk first
+#define VISUALIZER_PORT       3000
+#define VISUALIZER_ROOT       "dist"
+#define SERVER_MAX_PAGE_MOVES (1 << 20)
+#define SERVER_CHUNK_BYTES    65536
+
+#ifndef _WIN32
+typedef struct {
+    int fd;
+    char data[SERVER_CHUNK_BYTES];
+    size_t used;
+    int failed;
+} ChunkWriter;
+
+int sendAll(int fd, const void *data, size_t size) {
+    const char *p = (const char *)data;
+    while (size > 0) {
+        ssize_t sent = send(fd, p, size, MSG_NOSIGNAL);
+        if (sent <= 0) return 0;
+        p += sent;
+        size -= (size_t)sent;
+    }
+    return 1;
+}
+
+// Send buffered bytes as one HTTP/1.1 chunk
+void chunkFlush(ChunkWriter *w) {
+    char header[32];
+    if (w->used == 0 || w->failed) return;
+    int len = snprintf(header, sizeof(header), "%zx\r\n", w->used);
+    if (!sendAll(w->fd, header, len) || !sendAll(w->fd, w->data, w->used) || !sendAll(w->fd, "\r\n", 2)) {
+        w->failed = 1;
+    }
+    w->used = 0;
+}
+
+void chunkWrite(ChunkWriter *w, const void *data, size_t size) {
+    if (w->used + size > sizeof(w->data)) chunkFlush(w);
+    memcpy(w->data + w->used, data, size);
+    w->used += size;
+}
+
+void chunkPrintf(ChunkWriter *w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+void chunkPrintf(ChunkWriter *w, const char *fmt, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if (len > 0) chunkWrite(w, text, (size_t)len < sizeof(text) ? (size_t)len : sizeof(text) - 1);
+}
+
+void chunkEnd(ChunkWriter *w) {
+    chunkFlush(w);
+    if (!w->failed) sendAll(w->fd, "0\r\n\r\n", 5);
+}
+
+void sendSimpleResponse(int fd, int status, const char *reason, const char *type, const char *body) {
+    char header[256];
+    int len = snprintf(header, sizeof(header),
+                       "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                       "Connection: close\r\n\r\n", status, reason, type, strlen(body));
+    sendAll(fd, header, len);
+    sendAll(fd, body, strlen(body));
+}
+
+void startChunkedResponse(int fd, const char *type) {
+    char header[256];
+    int len = snprintf(header, sizeof(header),
+                       "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n"
+                       "Cache-Control: no-store\r\nConnection: close\r\n\r\n", type);
+    sendAll(fd, header, len);
+}
+
+// Value of `key` in a query string such as "n=25&start=1", or NULL
+const char *queryParam(const char *query, const char *key, char *out, size_t outSize) {
+    size_t keyLen = strlen(key);
+    const char *p = query;
+    
+    while (p && *p) {
+        if (strncmp(p, key, keyLen) == 0 && p[keyLen] == '=') {
+            p += keyLen + 1;
+            size_t len = strcspn(p, "&");
+            if (len >= outSize) len = outSize - 1;
+            memcpy(out, p, len);
+            out[len] = '\0';
+            return out;
+        }
+        p = strchr(p, '&');
+        if (p) p++;
+    }
+    return NULL;
+}
+
+int queryULL(const char *query, const char *key, unsigned long long *out) {
+    char text[32];
+    return queryParam(query, key, text, sizeof(text)) && parseULLArg(text, out);
+}
+
+void serveMoves(int fd, const char *query) {
+    unsigned long long n, first = 1, count = 1000;
+    char format[8] = "json";
+    
+    if (!queryULL(query, "n", &n) || n < 1 || n > 63) {
+        sendSimpleResponse(fd, 400, "Bad Request", "text/plain", "n must be 1-63\n");
+        return;
+    }
+    queryULL(query, "start", &first);
+    queryULL(query, "count", &count);
+    queryParam(query, "format", format, sizeof(format));
+    
+    unsigned long long total = (1ULL << n) - 1;
+    if (first < 1 || first > total) {
+        sendSimpleResponse(fd, 400, "Bad Request", "text/plain", "start must be 1-(2^n - 1)\n");
+        return;
+    }
+    if (count > SERVER_MAX_PAGE_MOVES) count = SERVER_MAX_PAGE_MOVES;
+    if (count > total - first + 1) count = total - first + 1;
+    
+    ChunkWriter *w = (ChunkWriter *)malloc(sizeof(ChunkWriter));
+    HanoiPackedMove page[4096];
+    HanoiCursor cursor;
+    size_t got;
+    if (!w) {
+        sendSimpleResponse(fd, 500, "Internal Server Error", "text/plain", "out of memory\n");
+        return;
+    }
+    w->fd = fd;
+    w->used = 0;
+    w->failed = 0;
+    
+    hanoiCursorInit(&cursor, (int)n);
+    hanoiCursorSeek(&cursor, first - 1);
+    int bin = strcmp(format, "bin") == 0;
+    
+    if (bin) {
+        startChunkedResponse(fd, "application/octet-stream");
+    } else {
+        startChunkedResponse(fd, "application/json");
+        chunkPrintf(w, "{\"n\":%llu,\"total\":%llu,\"start\":%llu,\"count\":%llu,\"moves\":[",
+                    n, total, first, count);
+    }
+    for (unsigned long long sent = 0; sent < count && !w->failed; sent += got) {
+        size_t want = count - sent < 4096 ? (size_t)(count - sent) : 4096;
+        got = hanoiCursorFill(&cursor, page, want);
+        for (size_t i = 0; i < got && !w->failed; i++) {
+            if (bin) {
+                uint8_t bytes[2] = { (uint8_t)(page[i] & 0xFF), (uint8_t)(page[i] >> 8) };
+                chunkWrite(w, bytes, 2);
+            } else {
+                chunkPrintf(w, "%s%d,%d,%d", sent + i == 0 ? "" : ",",
+                            HANOI_PACKED_DISK(page[i]), HANOI_PACKED_FROM(page[i]), HANOI_PACKED_TO(page[i]));
+            }
+        }
+    }
+    if (!bin) chunkPrintf(w, "]}");
+    chunkEnd(w);
+    free(w);
+}
+
+void serveState(int fd, const char *query) {
+    unsigned long long n, k = 0;
+    int pegOf[64];
+    char body[1024];
+    
+    if (!queryULL(query, "n", &n) || n < 1 || n > 63 || !queryULL(query, "k", &k) || k > (1ULL << n) - 1) {
+        sendSimpleResponse(fd, 400, "Bad Request", "text/plain", "need n (1-63) and k (0-(2^n - 1))\n");
+        return;
+    }
+    
+    hanoiStateAfter((int)n, k, pegOf);
+    int len = snprintf(body, sizeof(body), "{\"n\":%llu,\"k\":%llu,\"pegs\":[", n, k);
+    for (int p = 0; p < 3; p++) {
+        len += snprintf(body + len, sizeof(body) - len, "%s[", p ? "," : "");
+        int first = 1;
+        for (int d = (int)n; d >= 1; d--) {
+            if (pegOf[d] != p) continue;
+            len += snprintf(body + len, sizeof(body) - len, "%s%d", first ? "" : ",", d);
+            first = 0;
+        }
+        len += snprintf(body + len, sizeof(body) - len, "]");
+    }
+    snprintf(body + len, sizeof(body) - len, "]}");
+    sendSimpleResponse(fd, 200, "OK", "application/json", body);
+}
+
+const char *contentTypeFor(const char *path) {
+    const char *ext = strrchr(path, '.');
+    if (!ext) return "application/octet-stream";
+    if (strcmp(ext, ".html") == 0) return "text/html; charset=utf-8";
+    if (strcmp(ext, ".js") == 0) return "text/javascript";
+    if (strcmp(ext, ".css") == 0) return "text/css";
+    if (strcmp(ext, ".svg") == 0) return "image/svg+xml";
+    if (strcmp(ext, ".png") == 0) return "image/png";
+    if (strcmp(ext, ".json") == 0) return "application/json";
+    return "application/octet-stream";
+}
+
+// Opens path only when it is a regular file (fopen also accepts directories)
+FILE *openRegularFile(const char *path) {
+    struct stat st;
+    FILE *file = fopen(path, "rb");
+    
+    if (file && (fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode))) {
+        fclose(file);
+        file = NULL;
+    }
+    return file;
+}
+
+void serveFile(int fd, const char *root, const char *urlPath) {
+    char path[1024];
+    
+    if (strstr(urlPath, "..")) {
+        sendSimpleResponse(fd, 403, "Forbidden", "text/plain", "forbidden\n");
+        return;
+    }
+    if (strcmp(urlPath, "/") == 0) urlPath = "/index.html";
+    snprintf(path, sizeof(path), "%s%s", root, urlPath);
+    
+    FILE *file = openRegularFile(path);
+    const char *name = strrchr(urlPath, '/');
+    if (!file && !strchr(name ? name : urlPath, '.')) {
+        // Single-page app: unknown routes fall back to index.html (like serve -s)
+        snprintf(path, sizeof(path), "%s/index.html", root);
+        file = openRegularFile(path);
+    }
+    if (!file) {
+        sendSimpleResponse(fd, 404, "Not Found", "text/plain", "not found\n");
+        return;
+    }
+    
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        sendSimpleResponse(fd, 500, "Internal Server Error", "text/plain", "cannot read file\n");
+        return;
+    }
+    
+    char header[256];
+    int len = snprintf(header, sizeof(header),
+                       "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %ld\r\n"
+                       "Connection: close\r\n\r\n", contentTypeFor(path), size);
+    sendAll(fd, header, len);
+    
+    char buffer[65536];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        if (!sendAll(fd, buffer, got)) break;
+    }
+    fclose(file);
+}
+
+void handleConnection(int fd, const char *root) {
+    char request[8192];
+    size_t used = 0;
+    
+    // Read up to the end of the request headers
+    while (used < sizeof(request) - 1) {
+        ssize_t got = recv(fd, request + used, sizeof(request) - 1 - used, 0);
+        if (got <= 0) return;
+        used += (size_t)got;
+        request[used] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    
+    char method[8], target[2048];
+    if (sscanf(request, "%7s %2047s", method, target) != 2) {
+        sendSimpleResponse(fd, 400, "Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+    if (strcmp(method, "GET") != 0) {
+        sendSimpleResponse(fd, 405, "Method Not Allowed", "text/plain", "only GET is supported\n");
+        return;
+    }
+    
+    if (target[0] != '/') {
+        sendSimpleResponse(fd, 400, "Bad Request", "text/plain", "bad request target\n");
+        return;
+    }
+    
+    char *query = strchr(target, '?');
+    if (query) *query++ = '\0';
+    else query = "";
+    
+    if (strcmp(target, "/api/moves") == 0) serveMoves(fd, query);
+    else if (strcmp(target, "/api/state") == 0) serveState(fd, query);
+    else serveFile(fd, root, target);
+}
+
+// Blocking accept loop on 127.0.0.1:port. Returns only on setup failure.
+int serveVisualizer(int port, const char *root) {
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("socket");
+        return 1;
+    }
+    
+    int yes = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(server, 16) != 0) {
+        perror("bind");
+        close(server);
+        return 1;
+    }
+    
+    fprintf(stderr, "Serving %s on http://localhost:%d\n", root, port);
+    while (1) {
+        int client = accept(server, NULL, NULL);
+        if (client < 0) continue;
+        handleConnection(client, root);
+        close(client);
+    }
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════
+//  SOLVER DAEMON (POSIX)
+// ═══════════════════════════════════════════════════════════
+// Long-running query server on a Unix domain socket, so callers pay the
+// process start-up and table warm-up once instead of on every query.
+// Requests and answers are fixed-layout records in host byte order
+// (little-endian on every supported target), and a client may pipeline
+// any number of requests without waiting for the answers:
+//   request (40 bytes)  uint32 id, uint8 op, uint8 n, uint8 variant,
+//                       uint8 reserved, uint64 arg[4]
+//   answer  (12 bytes)  uint32 id, uint8 status, uint8 op, uint16 reserved,
+//                       uint32 payload bytes, followed by the payload
+// variant is 0 for the classic puzzle, 1 adjacent, 2 cyclic. A 128-bit move
+// index is two uint64 words, low word first. Answers to one client come back
+// in request order.
+//   SOLVE     moves first .. first+count-1 (first = arg[0..1], count = arg[2],
+//             at most DAEMON_MAX_MOVES) as uint16 PackedMoves
+//   COUNT     move count, 16 bytes
+//   KTH       move arg[0..1] as disk, from, to, 0 (4 bytes)
+//   DISTANCE  classic, n <= 63: shortest distance from configuration
+//             arg[0..1] to arg[2..3], 2 bits per disk with disk 1 in the low
+//             bits (8 bytes)
+//   STATS     requests, batches, cache hits, cache misses, cache bytes
+//             (5 x uint64)
+// Every readable client is drained before anything is answered, so the
+// requests that arrive together are served as one batch: a query repeated
+// across clients is computed once and large batches of misses are spread
+// over the worker threads. Small answers and DAEMON_BLOCK_MOVES-move blocks
+// of solutions stay in an LRU cache for later requests.
+#define DAEMON_SOCKET         "hanoi.sock"
+#define DAEMON_REQUEST_BYTES  40
+#define DAEMON_HEADER_BYTES   12
+#define DAEMON_MAX_CLIENTS    256
+#define DAEMON_CLIENT_BUFFER  (256 * DAEMON_REQUEST_BYTES)
+#define DAEMON_BATCH_MAX      4096                 // requests answered per round
+#define DAEMON_BLOCK_MOVES    65536                // moves per cached solution block
+#define DAEMON_MAX_MOVES      (1 << 20)            // moves per SOLVE answer
+#define DAEMON_MAX_BLOCKS     (DAEMON_MAX_MOVES / DAEMON_BLOCK_MOVES + 1)
+#define DAEMON_CACHE_MB       64
+#define DAEMON_OUTPUT_LIMIT   (16 << 20)           // unread answers before a client is paused
+#define DAEMON_BLOCK_WORK     64                   // a block costs about 64 small answers
+#define DAEMON_PARALLEL_WORK  1024                 // batch work worth starting the workers for
+
+#define DAEMON_OP_SOLVE       1
+#define DAEMON_OP_COUNT       2
+#define DAEMON_OP_KTH         3
+#define DAEMON_OP_DISTANCE    4
+#define DAEMON_OP_STATS       5
+
+#define DAEMON_OK             0
+#define DAEMON_BAD_REQUEST    1
+#define DAEMON_OUT_OF_RANGE   2
+#define DAEMON_NO_MEMORY      3
+
+#ifndef _WIN32
+typedef struct {
+    uint32_t id;
+    uint8_t op;
+    uint8_t n;
+    uint8_t variant;
+    uint8_t reserved;
+    uint64_t arg[4];
+} DaemonRequest;
+
+typedef struct {
+    uint32_t id;
+    uint8_t status;
+    uint8_t op;
+    uint16_t reserved;
+    uint32_t length;
+} DaemonAnswer;
+
+// Cache key: a small answer (op, n, variant, arguments) or, with op SOLVE,
+// solution block arg[0..1] of (variant, n)
+typedef struct {
+    uint64_t arg[4];
+    uint8_t op;
+    uint8_t n;
+    uint8_t variant;
+    uint8_t pad[5];
+} CacheKey;
+
+typedef struct CacheEntry {
+    CacheKey key;
+    uint64_t hash;
+    struct CacheEntry *newer;
+    struct CacheEntry *older;
+    struct CacheEntry *chain;     // next entry in the same bucket
+    unsigned char *data;          // NULL until the batch has computed it
+    size_t size;
+} CacheEntry;
+
+typedef struct {
+    CacheEntry **bucket;
+    size_t bucketMask;
+    CacheEntry *newest;
+    CacheEntry *oldest;
+    size_t bytes;                 // payloads plus entry overhead
+    size_t budget;
+} ResultCache;
+
+typedef struct {
+    int fd;
+    unsigned char in[DAEMON_CLIENT_BUFFER];
+    size_t inUsed;
+    unsigned char *out;
+    size_t outUsed;
+    size_t outSent;
+    size_t outCapacity;
+    int hungUp;                   // no more requests; close once answered
+    int closing;
+} DaemonClient;
+
+typedef struct {
+    DaemonClient *client;
+    DaemonRequest req;
+    int status;
+    CacheEntry *entry;            // COUNT, KTH and DISTANCE answer
+    HanoiMoveIndex first;         // SOLVE range, already clamped
+    size_t count;
+} DaemonItem;
+
+typedef struct {
+    CacheEntry **job;
+    size_t jobCount;
+    int threads;
+} DaemonWork;
+
+typedef struct {
+    unsigned long long requests;
+    unsigned long long batches;
+    unsigned long long hits;
+    unsigned long long misses;
+} DaemonStats;
+
+uint64_t cacheKeyHash(const CacheKey *key) {
+    uint64_t h = ((uint64_t)key->op << 16 | (uint64_t)key->n << 8 | key->variant) * 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 4; i++) {
+        h ^= key->arg[i] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h *= 0xBF58476D1CE4E5B9ULL;
+    }
+    return h ^ (h >> 31);
+}
+
+int cacheInit(ResultCache *c, size_t budget) {
+    size_t buckets = 1024;
+    while (buckets < budget / 256) buckets <<= 1;
+    c->bucket = (CacheEntry **)calloc(buckets, sizeof(CacheEntry *));
+    c->bucketMask = buckets - 1;
+    c->newest = c->oldest = NULL;
+    c->bytes = 0;
+    c->budget = budget;
+    return c->bucket != NULL;
+}
+
+void cacheUnlink(ResultCache *c, CacheEntry *e) {
+    if (e->newer) e->newer->older = e->older;
+    else c->newest = e->older;
+    if (e->older) e->older->newer = e->newer;
+    else c->oldest = e->newer;
+}
+
+void cachePushNewest(ResultCache *c, CacheEntry *e) {
+    e->newer = NULL;
+    e->older = c->newest;
+    if (c->newest) c->newest->newer = e;
+    else c->oldest = e;
+    c->newest = e;
+}
+
+// Entry for key, marked most recently used, or NULL
+CacheEntry *cacheFind(ResultCache *c, const CacheKey *key, uint64_t hash) {
+    for (CacheEntry *e = c->bucket[hash & c->bucketMask]; e; e = e->chain) {
+        if (e->hash == hash && memcmp(&e->key, key, sizeof(CacheKey)) == 0) {
+            if (c->newest != e) {
+                cacheUnlink(c, e);
+                cachePushNewest(c, e);
+            }
+            return e;
+        }
+    }
+    return NULL;
+}
+
+// New entry without data; the caller fills data and size
+CacheEntry *cacheInsert(ResultCache *c, const CacheKey *key, uint64_t hash) {
+    CacheEntry *e = (CacheEntry *)malloc(sizeof(CacheEntry));
+    if (!e) return NULL;
+    e->key = *key;
+    e->hash = hash;
+    e->data = NULL;
+    e->size = 0;
+    e->chain = c->bucket[hash & c->bucketMask];
+    c->bucket[hash & c->bucketMask] = e;
+    cachePushNewest(c, e);
+    c->bytes += sizeof(CacheEntry);
+    return e;
+}
+
+void cacheRemove(ResultCache *c, CacheEntry *e) {
+    CacheEntry **link = &c->bucket[e->hash & c->bucketMask];
+    while (*link != e) link = &(*link)->chain;
+    *link = e->chain;
+    cacheUnlink(c, e);
+    c->bytes -= sizeof(CacheEntry) + e->size;
+    free(e->data);
+    free(e);
+}
+
+// Evict least recently used entries until the cache fits its budget
+void cacheTrim(ResultCache *c) {
+    while (c->bytes > c->budget && c->oldest) cacheRemove(c, c->oldest);
+}
+
+void cacheFree(ResultCache *c) {
+    while (c->oldest) cacheRemove(c, c->oldest);
+    free(c->bucket);
+}
+
+HanoiMoveIndex daemonIndex(const uint64_t *words) {
+    return (HanoiMoveIndex)words[1] << 64 | words[0];
+}
+
+// Move count of variant 0 (classic), 1 (adjacent) or 2 (cyclic); 0 when n is out of range
+HanoiMoveIndex daemonMoveCount(int variant, int n) {
+    if (variant == 0) return n >= 1 && n <= HANOI_MAX_DISKS ? ((HanoiMoveIndex)1 << n) - 1 : 0;
+    return hanoiVariantMoveCount(variant - 1, n);
+}
+
+// Configuration packed 2 bits per disk (n <= 63); 0 when a peg is 3 or bits above disk n are set
+int daemonConfig(int n, const uint64_t *words, int *pegOf) {
+    if (words[n >> 5] >> (2 * (n & 31)) != 0 || (n < 32 && words[1] != 0)) return 0;
+    for (int d = 1; d <= n; d++) {
+        pegOf[d] = (int)(words[(d - 1) >> 5] >> (2 * ((d - 1) & 31)) & 3);
+        if (pegOf[d] == 3) return 0;
+    }
+    return 1;
+}
+
+void daemonKey(CacheKey *key, int op, const DaemonRequest *req) {
+    memset(key, 0, sizeof(CacheKey));
+    key->op = (uint8_t)op;
+    key->n = req->n;
+    key->variant = req->variant;
+}
+
+// Fill a pending entry; a failed allocation leaves data NULL
+void daemonCompute(CacheEntry *e) {
+    const CacheKey *key = &e->key;
+    int n = key->n;
+    
+    if (key->op == DAEMON_OP_SOLVE) {
+        HanoiMoveIndex start = daemonIndex(key->arg) * DAEMON_BLOCK_MOVES;
+        HanoiMoveIndex left = daemonMoveCount(key->variant, n) - start;
+        size_t count = left < DAEMON_BLOCK_MOVES ? (size_t)left : DAEMON_BLOCK_MOVES;
+        HanoiPackedMove *moves = (HanoiPackedMove *)malloc(count * sizeof(HanoiPackedMove));
+        size_t got = 0;
+        if (!moves) return;
+        if (key->variant == 0) {
+            HanoiCursor cursor;
+            hanoiCursorInit(&cursor, n);
+            hanoiCursorSeek(&cursor, start);
+            while (got < count) got += hanoiCursorFill(&cursor, moves + got, count - got);
+        } else {
+            HanoiVariantStream stream;
+            hanoiVariantStreamInit(&stream, key->variant - 1, n);
+            hanoiVariantStreamSeek(&stream, start);
+            while (got < count) got += hanoiVariantStreamFill(&stream, moves + got, count - got);
+        }
+        e->data = (unsigned char *)moves;
+        e->size = count * sizeof(HanoiPackedMove);
+        return;
+    }
+    
+    unsigned char *data = (unsigned char *)malloc(16);
+    if (!data) return;
+    if (key->op == DAEMON_OP_COUNT) {
+        HanoiMoveIndex count = daemonMoveCount(key->variant, n);
+        memcpy(data, &count, 16);
+        e->size = 16;
+    } else if (key->op == DAEMON_OP_KTH) {
+        HanoiMoveIndex k = daemonIndex(key->arg);
+        HanoiMove m = key->variant == 0 ? hanoiKthMove128(n, k) : hanoiVariantKthMove(key->variant - 1, n, k);
+        data[0] = (unsigned char)m.disk;
+        data[1] = (unsigned char)m.from;
+        data[2] = (unsigned char)m.to;
+        data[3] = 0;
+        e->size = 4;
+    } else {
+        int start[HANOI_ORACLE_MAX_DISKS + 1], target[HANOI_ORACLE_MAX_DISKS + 1];
+        daemonConfig(n, key->arg, start);
+        daemonConfig(n, key->arg + 2, target);
+        uint64_t distance = hanoiDistance(n, start, target);
+        memcpy(data, &distance, 8);
+        e->size = 8;
+    }
+    e->data = data;
+}
+
+void daemonWorker(int id, void *arg) {
+    DaemonWork *w = (DaemonWork *)arg;
+    for (size_t j = (size_t)id; j < w->jobCount; j += (size_t)w->threads) {
+        daemonCompute(w->job[j]);
+    }
+}
+
+// Check a request and clamp its range; returns a DAEMON_ status
+int daemonValidate(DaemonItem *item) {
+    const DaemonRequest *req = &item->req;
+    int pegOf[HANOI_ORACLE_MAX_DISKS + 1];
+    
+    if (req->op == DAEMON_OP_STATS) return DAEMON_OK;
+    if (req->op < DAEMON_OP_SOLVE || req->op > DAEMON_OP_DISTANCE || req->variant > 2) return DAEMON_BAD_REQUEST;
+    if (req->op == DAEMON_OP_DISTANCE) {
+        if (req->variant != 0 || req->n < 1 || req->n > HANOI_ORACLE_MAX_DISKS
+            || !daemonConfig(req->n, req->arg, pegOf) || !daemonConfig(req->n, req->arg + 2, pegOf)) {
+            return DAEMON_BAD_REQUEST;
+        }
+        return DAEMON_OK;
+    }
+    
+    HanoiMoveIndex total = daemonMoveCount(req->variant, req->n);
+    if (total == 0) return DAEMON_BAD_REQUEST;
+    if (req->op == DAEMON_OP_COUNT) return DAEMON_OK;
+    
+    HanoiMoveIndex k = daemonIndex(req->arg);
+    if (k < 1 || k > total) return DAEMON_OUT_OF_RANGE;
+    if (req->op == DAEMON_OP_KTH) return DAEMON_OK;
+    
+    HanoiMoveIndex count = req->arg[2] < DAEMON_MAX_MOVES ? req->arg[2] : DAEMON_MAX_MOVES;
+    if (count > total - k + 1) count = total - k + 1;
+    item->first = k;
+    item->count = (size_t)count;
+    return DAEMON_OK;
+}
+
+// Room for `size` more bytes of answers; 0 when the buffer cannot grow
+int daemonReserve(DaemonClient *client, size_t size) {
+    if (client->outSent == client->outUsed) client->outSent = client->outUsed = 0;
+    if (client->outUsed + size <= client->outCapacity) return 1;
+    
+    size_t capacity = client->outCapacity ? client->outCapacity : 65536;
+    while (capacity < client->outUsed + size) capacity *= 2;
+    unsigned char *out = (unsigned char *)realloc(client->out, capacity);
+    if (!out) return 0;
+    client->out = out;
+    client->outCapacity = capacity;
+    return 1;
+}
+
+// Queue an answer; returns where its payload goes (copied from payload
+// unless NULL), or NULL when the answer was dropped
+unsigned char *daemonAnswer(DaemonItem *item, int status, const void *payload, size_t size) {
+    DaemonClient *client = item->client;
+    DaemonAnswer answer;
+    
+    if (status != DAEMON_OK) size = 0;
+    if (client->closing) return NULL;
+    if (!daemonReserve(client, DAEMON_HEADER_BYTES + size)) {
+        client->closing = 1;
+        return NULL;
+    }
+    answer.id = item->req.id;
+    answer.status = (uint8_t)status;
+    answer.op = item->req.op;
+    answer.reserved = 0;
+    answer.length = (uint32_t)size;
+    memcpy(client->out + client->outUsed, &answer, DAEMON_HEADER_BYTES);
+    
+    unsigned char *out = client->out + client->outUsed + DAEMON_HEADER_BYTES;
+    if (payload && size > 0) memcpy(out, payload, size);
+    client->outUsed += DAEMON_HEADER_BYTES + size;
+    return out;
+}
+
+void daemonBlockKey(CacheKey *key, const DaemonItem *item, HanoiMoveIndex block) {
+    daemonKey(key, DAEMON_OP_SOLVE, &item->req);
+    key->arg[0] = (uint64_t)block;
+    key->arg[1] = (uint64_t)(block >> 64);
+}
+
+// Copy moves first .. first+count-1 out of the cached blocks
+void daemonAnswerMoves(ResultCache *cache, DaemonItem *item) {
+    HanoiMoveIndex block = (item->first - 1) / DAEMON_BLOCK_MOVES;
+    HanoiMoveIndex last = (item->first + item->count - 2) / DAEMON_BLOCK_MOVES;
+    size_t skip = (size_t)((item->first - 1) % DAEMON_BLOCK_MOVES) * sizeof(HanoiPackedMove);
+    size_t size = item->count * sizeof(HanoiPackedMove);
+    CacheEntry *blocks[DAEMON_MAX_BLOCKS + 1];
+    CacheKey key;
+    
+    for (HanoiMoveIndex b = block; item->count > 0 && b <= last; b++) {
+        daemonBlockKey(&key, item, b);
+        blocks[b - block] = cacheFind(cache, &key, cacheKeyHash(&key));
+        if (!blocks[b - block] || !blocks[b - block]->data) {
+            daemonAnswer(item, DAEMON_NO_MEMORY, NULL, 0);
+            return;
+        }
+    }
+    
+    unsigned char *out = daemonAnswer(item, DAEMON_OK, NULL, size);
+    if (!out) return;
+    for (size_t i = 0, copied = 0; copied < size; i++) {
+        size_t take = blocks[i]->size - skip;
+        if (take > size - copied) take = size - copied;
+        memcpy(out + copied, blocks[i]->data + skip, take);
+        copied += take;
+        skip = 0;
+    }
+}
+
+// Answer one round of requests: look everything up, compute every distinct
+// miss once (in parallel when the round is big enough), then answer in order
+void daemonServeBatch(ResultCache *cache, DaemonStats *stats, DaemonItem *items, size_t count,
+                      CacheEntry **jobs, int threads) {
+    DaemonWork work;
+    size_t jobCount = 0, effort = 0;
+    CacheKey key;
+    
+    stats->batches++;
+    stats->requests += count;
+    for (size_t i = 0; i < count; i++) {
+        DaemonItem *item = &items[i];
+        item->entry = NULL;
+        item->count = 0;
+        item->status = daemonValidate(item);
+        if (item->status != DAEMON_OK || item->req.op == DAEMON_OP_STATS) continue;
+        
+        if (item->req.op == DAEMON_OP_SOLVE) {
+            HanoiMoveIndex last = (item->first + item->count - 2) / DAEMON_BLOCK_MOVES;
+            for (HanoiMoveIndex b = (item->first - 1) / DAEMON_BLOCK_MOVES; item->count > 0 && b <= last; b++) {
+                daemonBlockKey(&key, item, b);
+                uint64_t hash = cacheKeyHash(&key);
+                if (cacheFind(cache, &key, hash)) {
+                    stats->hits++;
+                    continue;
+                }
+                CacheEntry *e = cacheInsert(cache, &key, hash);
+                if (!e) break;
+                jobs[jobCount++] = e;
+                effort += DAEMON_BLOCK_WORK;
+                stats->misses++;
+            }
+            continue;
+        }
+        
+        daemonKey(&key, item->req.op, &item->req);
+        if (item->req.op != DAEMON_OP_COUNT) {
+            key.arg[0] = item->req.arg[0];
+            key.arg[1] = item->req.arg[1];
+        }
+        if (item->req.op == DAEMON_OP_DISTANCE) {
+            key.arg[2] = item->req.arg[2];
+            key.arg[3] = item->req.arg[3];
+        }
+        uint64_t hash = cacheKeyHash(&key);
+        item->entry = cacheFind(cache, &key, hash);
+        if (item->entry) {
+            stats->hits++;
+            continue;
+        }
+        item->entry = cacheInsert(cache, &key, hash);
+        if (!item->entry) continue;
+        jobs[jobCount++] = item->entry;
+        effort++;
+        stats->misses++;
+    }
+    
+    work.job = jobs;
+    work.jobCount = jobCount;
+    work.threads = effort >= DAEMON_PARALLEL_WORK ? threads : 1;
+    if (work.threads > (int)jobCount) work.threads = jobCount > 0 ? (int)jobCount : 1;
+    if (work.threads > 1) hanoiParallelRun(work.threads, daemonWorker, &work);
+    else daemonWorker(0, &work);
+    for (size_t j = 0; j < jobCount; j++) cache->bytes += jobs[j]->size;
+    
+    for (size_t i = 0; i < count; i++) {
+        DaemonItem *item = &items[i];
+        if (item->status != DAEMON_OK) {
+            daemonAnswer(item, item->status, NULL, 0);
+        } else if (item->req.op == DAEMON_OP_STATS) {
+            uint64_t values[5] = { stats->requests, stats->batches, stats->hits, stats->misses, cache->bytes };
+            daemonAnswer(item, DAEMON_OK, values, sizeof(values));
+        } else if (item->req.op == DAEMON_OP_SOLVE) {
+            daemonAnswerMoves(cache, item);
+        } else if (!item->entry || !item->entry->data) {
+            daemonAnswer(item, DAEMON_NO_MEMORY, NULL, 0);
+        } else {
+            daemonAnswer(item, DAEMON_OK, item->entry->data, item->entry->size);
+        }
+    }
+    
+    // Entries whose allocation failed are dropped, then the cache is trimmed
+    for (size_t j = 0; j < jobCount; j++) {
+        if (!jobs[j]->data) cacheRemove(cache, jobs[j]);
+    }
+    cacheTrim(cache);
+}
+
+// Read what the socket has; 0 when the connection failed
+int daemonRead(DaemonClient *client) {
+    while (client->inUsed < sizeof(client->in)) {
+        ssize_t got = recv(client->fd, client->in + client->inUsed, sizeof(client->in) - client->inUsed, 0);
+        if (got > 0) {
+            client->inUsed += (size_t)got;
+        } else if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 1;
+        } else if (got < 0 && errno == EINTR) {
+            continue;
+        } else {
+            client->hungUp = 1;
+            return got == 0;
+        }
+    }
+    return 1;
+}
+
+// Send buffered answers without blocking; 0 when the client is gone
+int daemonFlush(DaemonClient *client) {
+    while (client->outSent < client->outUsed) {
+        ssize_t sent = send(client->fd, client->out + client->outSent, client->outUsed - client->outSent,
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0) {
+            client->outSent += (size_t)sent;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 1;
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return 0;
+        }
+    }
+    client->outSent = client->outUsed = 0;
+    return 1;
+}
+
+// A client whose answers are not being read is paused until it catches up
+int daemonReady(const DaemonClient *client) {
+    return !client->closing && client->outUsed - client->outSent < DAEMON_OUTPUT_LIMIT;
+}
+
+// Upper bound of the answer to req, before it is validated
+size_t daemonAnswerBound(const DaemonRequest *req) {
+    if (req->op != DAEMON_OP_SOLVE) return DAEMON_HEADER_BYTES + 5 * sizeof(uint64_t);
+    size_t count = req->arg[2] < DAEMON_MAX_MOVES ? (size_t)req->arg[2] : DAEMON_MAX_MOVES;
+    return DAEMON_HEADER_BYTES + count * sizeof(HanoiPackedMove);
+}
+
+// Upper bound of the solution blocks req may add to the cache
+size_t daemonBlockBound(const DaemonRequest *req) {
+    if (req->op != DAEMON_OP_SOLVE || req->arg[2] == 0) return 0;
+    size_t count = req->arg[2] < DAEMON_MAX_MOVES ? (size_t)req->arg[2] : DAEMON_MAX_MOVES;
+    return (count + DAEMON_BLOCK_MOVES - 1) / DAEMON_BLOCK_MOVES + 1;
+}
+
+// A complete request is waiting and its answer fits under DAEMON_OUTPUT_LIMIT
+int daemonPending(const DaemonClient *client) {
+    DaemonRequest req;
+    if (client->closing || client->inUsed < DAEMON_REQUEST_BYTES) return 0;
+    memcpy(&req, client->in, DAEMON_REQUEST_BYTES);
+    return client->outUsed - client->outSent + daemonAnswerBound(&req) <= DAEMON_OUTPUT_LIMIT;
+}
+
+// Build the lazily initialised tables before the first client arrives
+void daemonWarmUp() {
+    HanoiPackedMove moves[4096];
+    HanoiCursor cursor;
+    HanoiVariantStream stream;
+    int start[4] = { 0, 0, 1, 2 }, target[4] = { 0, 2, 2, 2 };
+    
+    hanoiCursorInit(&cursor, 20);
+    hanoiCursorFill(&cursor, moves, 4096);
+    for (int v = 0; v < 2; v++) {
+        hanoiVariantStreamInit(&stream, v, 12);
+        hanoiVariantStreamFill(&stream, moves, 4096);
+    }
+    hanoiDistance(3, start, target);
+}
+
+// Event loop on a Unix domain socket until SIGINT or SIGTERM
+int runDaemon(const char *path, int threads, int cacheMb) {
+    struct sockaddr_un addr;
+    ResultCache cache;
+    DaemonStats stats = { 0, 0, 0, 0 };
+    
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 2;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    
+    // A live daemon keeps its socket; a file left by one that died is replaced
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        fprintf(stderr, "A daemon is already listening on %s\n", path);
+        close(probe);
+        return 1;
+    }
+    if (probe >= 0) close(probe);
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "%s: path exists and is not a socket\n", path);
+            return 2;
+        }
+        unlink(path);
+    }
+    
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("socket");
+        return 1;
+    }
+    // Owner-only socket: other local users cannot drive the daemon
+    mode_t previousMask = umask(0177);
+    int bound = bind(server, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    umask(previousMask);
+    if (!bound || listen(server, 64) != 0) {
+        perror("bind");
+        close(server);
+        return 1;
+    }
+    fcntl(server, F_SETFL, fcntl(server, F_GETFL) | O_NONBLOCK);
+    
+    DaemonClient **clients = (DaemonClient **)calloc(DAEMON_MAX_CLIENTS, sizeof(DaemonClient *));
+    struct pollfd *fds = (struct pollfd *)malloc((DAEMON_MAX_CLIENTS + 1) * sizeof(struct pollfd));
+    DaemonItem *items = (DaemonItem *)malloc(DAEMON_BATCH_MAX * sizeof(DaemonItem));
+    CacheEntry **jobs = (CacheEntry **)malloc(DAEMON_BATCH_MAX * (DAEMON_MAX_BLOCKS + 1) * sizeof(CacheEntry *));
+    if (!clients || !fds || !items || !jobs || !cacheInit(&cache, (size_t)cacheMb << 20)) {
+        fprintf(stderr, "Out of memory\n");
+        close(server);
+        unlink(path);
+        return 1;
+    }
+    
+    daemonWarmUp();
+    solveInterrupted = 0;
+    void (*previousInt)(int) = signal(SIGINT, onInterrupt);
+    void (*previousTerm)(int) = signal(SIGTERM, onInterrupt);
+    fprintf(stderr, "Solver daemon on %s (%d threads, %d MB cache)\n", path, threads, cacheMb);
+    
+    int clientCount = 0;
+    size_t round = 0;
+    int backlog = 0;                 // requests that can be cut without waiting for the socket
+    size_t blockCap = cache.budget / (DAEMON_BLOCK_MOVES * sizeof(HanoiPackedMove));
+    if (blockCap < DAEMON_MAX_BLOCKS) blockCap = DAEMON_MAX_BLOCKS;
+    while (!solveInterrupted) {
+        fds[0].fd = server;
+        fds[0].events = clientCount < DAEMON_MAX_CLIENTS ? POLLIN : 0;
+        for (int c = 0; c < clientCount; c++) {
+            DaemonClient *client = clients[c];
+            fds[c + 1].fd = client->fd;
+            fds[c + 1].events = 0;
+            if (daemonReady(client) && !client->hungUp && client->inUsed < sizeof(client->in)) {
+                fds[c + 1].events |= POLLIN;
+            }
+            if (client->outSent < client->outUsed) fds[c + 1].events |= POLLOUT;
+            fds[c + 1].revents = 0;
+        }
+        
+        if (poll(fds, (nfds_t)clientCount + 1, backlog ? 0 : -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        
+        // Drain every readable client first, so their requests share a round
+        for (int c = 0; c < clientCount; c++) {
+            if (fds[c + 1].revents & POLLOUT) {
+                if (!daemonFlush(clients[c])) clients[c]->closing = 1;
+            }
+            if (fds[c + 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (!daemonRead(clients[c])) clients[c]->closing = 1;
+            }
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while (clientCount < DAEMON_MAX_CLIENTS && (fd = accept(server, NULL, NULL)) >= 0) {
+                DaemonClient *client = (DaemonClient *)calloc(1, sizeof(DaemonClient));
+                if (!client) {
+                    close(fd);
+                    break;
+                }
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                client->fd = fd;
+                clients[clientCount++] = client;
+                if (!daemonRead(client)) client->closing = 1;
+            }
+        }
+        
+        // Cut complete requests into the batch, starting at a rotating client.
+        // A client's requests stop where its queued answers would pass
+        // DAEMON_OUTPUT_LIMIT, and the round stops where the blocks it may
+        // compute would pass the cache budget; the rest waits in client->in.
+        size_t count = 0, blocks = 0;
+        for (int step = 0; step < clientCount; step++) {
+            DaemonClient *client = clients[(round + (size_t)step) % (size_t)clientCount];
+            size_t used = 0, queued = client->outUsed - client->outSent;
+            if (!daemonReady(client)) continue;
+            while (client->inUsed - used >= DAEMON_REQUEST_BYTES && count < DAEMON_BATCH_MAX) {
+                DaemonRequest *req = &items[count].req;
+                memcpy(req, client->in + used, DAEMON_REQUEST_BYTES);
+                size_t answer = daemonAnswerBound(req), need = daemonBlockBound(req);
+                if (queued + answer > DAEMON_OUTPUT_LIMIT || (count > 0 && blocks + need > blockCap)) break;
+                queued += answer;
+                blocks += need;
+                items[count].client = client;
+                used += DAEMON_REQUEST_BYTES;
+                count++;
+            }
+            memmove(client->in, client->in + used, client->inUsed - used);
+            client->inUsed -= used;
+        }
+        round++;
+        
+        if (count > 0) {
+            daemonServeBatch(&cache, &stats, items, count, jobs, threads);
+            for (size_t i = 0; i < count; i++) {
+                DaemonClient *client = items[i].client;
+                if (!client->closing && client->outSent < client->outUsed && !daemonFlush(client)) {
+                    client->closing = 1;
+                }
+            }
+        }
+        
+        for (int c = 0; c < clientCount; c++) {
+            DaemonClient *client = clients[c];
+            if (client->hungUp && client->inUsed < DAEMON_REQUEST_BYTES && client->outSent == client->outUsed) {
+                client->closing = 1;
+            }
+            if (!client->closing) continue;
+            close(client->fd);
+            free(client->out);
+            free(client);
+            clients[c--] = clients[--clientCount];
+        }
+        
+        backlog = 0;
+        for (int c = 0; c < clientCount; c++) {
+            if (daemonPending(clients[c])) backlog = 1;
+        }
+    }
+    
+    signal(SIGINT, previousInt);
+    signal(SIGTERM, previousTerm);
+    for (int c = 0; c < clientCount; c++) {
+        close(clients[c]->fd);
+        free(clients[c]->out);
+        free(clients[c]);
+    }
+    close(server);
+    unlink(path);
+    fprintf(stderr, "Served %llu requests in %llu batches (cache: %llu hits, %llu misses)\n",
+            stats.requests, stats.batches, stats.hits, stats.misses);
+    cacheFree(&cache);
+    free(clients);
+    free(fds);
+    free(items);
+    free(jobs);
+    return 0;
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════
+//  VISUALIZER LAUNCHER
+// ═══════════════════════════════════════════════════════════
+void launchVisualizer() {
+    clearScreen();
+    printf("\n");
+    printBox("LAUNCHING VISUALIZER", BRIGHT_CYAN);
+    printf("\n");
+    
+    #ifdef _WIN32
+    printf("%s  Opening graphical visualizer...%s\n\n", BRIGHT_GREEN, RESET);
+    system("start \"\" \"dist\\run.bat\"");
+    pressAnyKey();
+    #else
+    fflush(stdout);
+    pid_t server = fork();
+    if (server == 0) {
+        _exit(serveVisualizer(VISUALIZER_PORT, VISUALIZER_ROOT));
+    }
+    if (server < 0) {
+        printf("%s  Warning: Could not start the visualizer server.%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    printf("%s  Visualizer running at http://localhost:%d%s\n", BRIGHT_GREEN, VISUALIZER_PORT, RESET);
+    printf("  Moves are streamed from /api/moves by the native engine.\n");
+    system("xdg-open http://localhost:3000 >/dev/null 2>&1 &");
+    
+    printf("\n%s%s[Press ENTER to stop the server...]%s", DIM, BRIGHT_BLACK, RESET);
+    getchar();
+    getchar();
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    #endif
+}
+
+// ═══════════════════════════════════════════════════════════
+//  ENGINE REGISTRY
+// ═══════════════════════════════════════════════════════════
+typedef struct {
+    const char *name;
+    void (*solve)(int n);
+    int (*verify)(int n);                   // optional cross-check against the reference engine
+    unsigned long long (*moveCount)(int n); // NULL for the classic 2^n - 1
+} Engine;
+
+void solveRecursive(int n) {
+    HanoiContext ctx = { 0, NULL };
+    hanoi(&ctx, n, 'A', 'C', 'B');
+}
+
+// Stack engine on pegs[0..2] = A, B, C (created with capacity n), which are
+// left in their final state
+void runStackEngine(int n, Stack pegs[3]) {
+    Stack *src = &pegs[0];
+    Stack *aux = &pegs[1];
+    Stack *dest = &pegs[2];
+    
+    for (int i = n; i >= 1; i--) hanoiStackPush(src, i);
+    
+    long long totalMoves = (1LL << n) - 1;
+    char S = 'A', A = 'B', D = 'C';
+    if (n % 2 == 0) {
+        Stack *t = dest; dest = aux; aux = t;
+        char c = D; D = A; A = c;
+    }
+    
+    for (long long i = 1; i <= totalMoves; i++) {
+        if (i % 3 == 1) hanoiLegalMove(src, dest, S, D);
+        else if (i % 3 == 2) hanoiLegalMove(src, aux, S, A);
+        else hanoiLegalMove(aux, dest, A, D);
+    }
+}
+
+void solveIterative(int n) {
+    Stack pegs[3];
+    size_t mark = hanoiArenaMark();
+    for (int p = 0; p < 3; p++) pegs[p] = requireStack(hanoiPegStackCreate(n), n);
+    
+    runStackEngine(n, pegs);
+    
+    for (int p = 0; p < 3; p++) hanoiPegStackRelease(&pegs[p]);
+    hanoiArenaRelease(mark);
+}
+
+// 1 when the bitboard engine ends in exactly the state the stack engine does
+int verifyBitboard(int n) {
+    Stack pegs[3];
+    int same = 1;
+    
+    size_t mark = hanoiArenaMark();
+    for (int p = 0; p < 3; p++) pegs[p] = requireStack(hanoiPegStackCreate(n), n);
+    runStackEngine(n, pegs);
+    hanoiSolveBitboard(n);
+    
+    for (int p = 0; p < 3; p++) {
+        uint64_t mask = BITBOARD_FLOOR;
+        for (int i = 0; i <= pegs[p].top; i++) mask |= 1ULL << (pegs[p].arr[i] - 1);
+        if (mask != hanoiBitboardResult.peg[p]) same = 0;
+        hanoiPegStackRelease(&pegs[p]);
+    }
+    hanoiArenaRelease(mark);
+    return same;
+}
+
+// Moves written by the parallel engine match the closed-form k-th move;
+// above 20 disks only the move count is compared
+int verifyParallel(int n) {
+    unsigned long long total = (1ULL << n) - 1;
+    if (n > 20) return hanoiParallel(n, hanoiParallelThreadCount(), NULL) == total;
+    
+    HanoiPackedMove *out = (HanoiPackedMove *)malloc(total * sizeof(HanoiPackedMove));
+    if (!out) return 0;
+    
+    int same = hanoiParallel(n, hanoiParallelThreadCount(), out) == total;
+    for (unsigned long long k = 1; same && k <= total; k++) {
+        HanoiMove m = hanoiKthMove(n, k);
+        same = out[k - 1] == HANOI_PACK_MOVE(m.disk, m.from, m.to);
+    }
+    free(out);
+    return same;
+}
+
+Engine engines[] = {
+    { "recursive",    solveRecursive,    NULL,               NULL },
+    { "iterative",    solveIterative,    NULL,               NULL },
+    { "bitboard",     hanoiSolveBitboard,     verifyBitboard,     NULL },
+    { "framestewart", hanoiSolveFrameStewart, hanoiVerifyFrameStewart, hanoiFrameStewartEngineMoves },
+    { "block",        hanoiSolveBlockDoubling, hanoiVerifyBlockDoubling, NULL },
+    { "kernel",       hanoiSolveKernel,        hanoiVerifyKernel,        NULL },
+    { "parallel",     hanoiSolveParallel,      verifyParallel,      NULL },
+    { "cursor",       hanoiSolveCursor,        hanoiVerifyCursor,        NULL },
+    { "simd",         hanoiSolveSimd,          hanoiVerifySimd,          NULL },
+    { "adjacent",     hanoiSolveAdjacent,      hanoiVerifyAdjacent,      hanoiAdjacentEngineMoves },
+    { "cyclic",       hanoiSolveCyclic,        hanoiVerifyCyclic,        hanoiCyclicEngineMoves },
+};
+#define ENGINE_COUNT ((int)(sizeof(engines) / sizeof(engines[0])))
+
+int findEngine(const char *name) {
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        if (strcmp(engines[e].name, name) == 0) return e;
+    }
+    return -1;
+}
+
+unsigned long long engineMoveCount(int engine, int n) {
+    if (engines[engine].moveCount) return engines[engine].moveCount(n);
+    return (1ULL << n) - 1;
+}
+
+// Engine name for reports, with the peg count for multi-peg engines
+const char *engineLabel(int engine) {
+    static char label[48];
+    if (engines[engine].solve == hanoiSolveFrameStewart) {
+        snprintf(label, sizeof(label), "%s-p%d", engines[engine].name, hanoiFrameStewartPegs);
+        return label;
+    }
+    if (engines[engine].solve == hanoiSolveParallel) {
+        snprintf(label, sizeof(label), "%s-t%d", engines[engine].name, hanoiParallelThreadCount());
+        return label;
+    }
+    if (engines[engine].solve == hanoiSolveSimd) {
+        snprintf(label, sizeof(label), "%s-%s", engines[engine].name, hanoiSimdPathName(hanoiSimdActivePath()));
+        return label;
+    }
+    return engines[engine].name;
+}
+
+#define SCHEDULER_ARENA_BYTES (1 << 20)    // three 62-disk pegs plus one move chunk
+
+// Measurements on the calling thread get the same scratch arena as the batch
+// workers, so the engines' move chunks do not go through malloc while timed.
+// Returns 1 when it installed one.
+int engineArenaBegin(Arena *arena) {
+    if (hanoiThreadArena || !hanoiArenaInit(arena, SCHEDULER_ARENA_BYTES)) return 0;
+    hanoiThreadArena = arena;
+    return 1;
+}
+
+void engineArenaEnd(Arena *arena, int installed) {
+    if (!installed) return;
+    hanoiThreadArena = NULL;
+    hanoiArenaFree(arena);
+}
+
+void measureEngine(int engine, int n, int minSamples, TimingStats *stats) {
+    Arena arena;
+    int installed = engineArenaBegin(&arena);
+    
+    measureSolve(engines[engine].solve, n, minSamples, stats);
+    engineArenaEnd(&arena, installed);
+}
+
+// Counters over one timing batch (stats->innerRuns solves)
+void perfEngine(int engine, int n, const TimingStats *stats, PerfSample *perf) {
+    Arena arena;
+    int installed = engineArenaBegin(&arena);
+    
+    perfMeasure(engines[engine].solve, n, stats->innerRuns, perf);
+    engineArenaEnd(&arena, installed);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BATCH SCHEDULER
+// ═══════════════════════════════════════════════════════════
+// A sweep is a list of independent (engine, n, repetition) jobs. Pinned
+// workers claim them from a shared counter, largest n first so the long
+// jobs do not end up last. A timing job doubles its inner loop until one
+// batch lasts TIMING_MIN_SAMPLE_NS and records that batch as one sample;
+// a verification job runs the engine's cross-check. Each worker owns an
+// arena for peg stacks and move chunks, so jobs do not go through malloc.
+// Quiet mode runs the jobs one at a time on an isolated core instead.
+
+typedef struct {
+    int engine;
+    int n;
+    int rep;              // timing repetition, -1 for the cross-check
+    double ns;            // per-solve time of this repetition
+    long long innerRuns;
+    int verified;
+} BatchJob;
+
+typedef struct {
+    BatchJob *jobs;
+    int count;
+    int next;             // next unclaimed job (atomic)
+    int firstCpu;         // -1: worker i runs on CPU i
+    int pinned;           // workers that got their affinity (atomic)
+} BatchSchedule;
+
+int batchWorkers = 0;     // scheduler threads, 0 = one per core
+int batchQuiet = 0;       // one job at a time on an isolated core
+
+// Build the lazily initialised engine tables once, before any worker runs
+void enginesPrepare() {
+    hanoiFrameStewartInit();
+    for (int k = 1; k <= HANOI_BLOCK_DISKS; k++) hanoiBlockTableFor(k);
+}
+
+void batchRunJob(BatchJob *job) {
+    void (*solve)(int) = engines[job->engine].solve;
+    int n = job->n;
+    
+    if (job->rep < 0) {
+        job->verified = engines[job->engine].verify(n);
+        return;
+    }
+    for (long long inner = 1; ; inner *= 2) {
+        long long t0 = hanoiNowNs();
+        for (long long r = 0; r < inner; r++) solve(n);
+        long long elapsed = hanoiNowNs() - t0;
+        if (elapsed >= TIMING_MIN_SAMPLE_NS) {
+            job->ns = (double)elapsed / inner;
+            job->innerRuns = inner;
+            return;
+        }
+    }
+}
+
+void batchWorker(int id, void *arg) {
+    BatchSchedule *s = (BatchSchedule *)arg;
+    Arena arena;
+    int cpu = s->firstCpu >= 0 ? s->firstCpu : id % hanoiHardwareThreads();
+    
+    if (hanoiPinToCpu(cpu)) __atomic_add_fetch(&s->pinned, 1, __ATOMIC_RELAXED);
+    if (hanoiArenaInit(&arena, SCHEDULER_ARENA_BYTES)) hanoiThreadArena = &arena;
+    
+    while (1) {
+        int j = __atomic_fetch_add(&s->next, 1, __ATOMIC_RELAXED);
+        if (j >= s->count) break;
+        batchRunJob(&s->jobs[j]);
+    }
+    
+    hanoiThreadArena = NULL;
+    hanoiArenaFree(&arena);
+}
+
+int compareJobsBySize(const void *a, const void *b) {
+    const BatchJob *x = (const BatchJob *)a;
+    const BatchJob *y = (const BatchJob *)b;
+    if (x->n != y->n) return y->n - x->n;
+    return (x->rep < 0) - (y->rep < 0);        // timing before cross-checks
+}
+
+// Run the jobs on `workers` threads (0 = one per core), or on one thread
+// pinned to hanoiQuietCpu() when quiet. The calling thread only waits, so its
+// own affinity is left alone. Returns the number of pinned workers.
+int batchRun(BatchJob *jobs, int count, int workers, int quiet) {
+    BatchSchedule s = { jobs, count, 0, quiet ? hanoiQuietCpu() : -1, 0 };
+    Thread threads[HANOI_MAX_THREADS];
+    
+    if (quiet) workers = 1;
+    if (workers < 1) workers = hanoiHardwareThreads();
+    if (workers > HANOI_MAX_THREADS) workers = HANOI_MAX_THREADS;
+    if (workers > count) workers = count;
+    
+    enginesPrepare();
+    qsort(jobs, count, sizeof(BatchJob), compareJobsBySize);
+    
+    for (int t = 0; t < workers; t++) hanoiThreadStart(&threads[t], batchWorker, t, &s);
+    for (int t = 0; t < workers; t++) hanoiThreadJoin(&threads[t]);
+    return s.pinned;
+}
+
+// Time engineList[0..engineCount) for n = minDisks..maxDisks with `repeats`
+// samples each, plus one cross-check job per row when check is set. Row
+// (e, n) lands in stats[e * span + n - minDisks] and verified[...] (1 ok,
+// 0 mismatch, -1 no verifier). Returns the number of pinned workers, or
+// -1 when out of memory.
+int batchSweep(const int *engineList, int engineCount, int minDisks, int maxDisks, int repeats,
+               int check, TimingStats *stats, int *verified) {
+    int span = maxDisks - minDisks + 1;
+    int rows = engineCount * span;
+    
+    if (repeats > TIMING_MAX_SAMPLES) repeats = TIMING_MAX_SAMPLES;
+    BatchJob *jobs = (BatchJob *)malloc((size_t)rows * (repeats + 1) * sizeof(BatchJob));
+    if (!jobs) return -1;
+    
+    int count = 0;
+    for (int row = 0; row < rows; row++) {
+        int engine = engineList[row / span];
+        int n = minDisks + row % span;
+        verified[row] = -1;
+        for (int rep = 0; rep < repeats; rep++) {
+            jobs[count++] = (BatchJob){ engine, n, rep, 0.0, 0, -1 };
+        }
+        if (check && engines[engine].verify) jobs[count++] = (BatchJob){ engine, n, -1, 0.0, 0, -1 };
+    }
+    
+    int pinned = batchRun(jobs, count, batchWorkers, batchQuiet);
+    
+    for (int row = 0; row < rows; row++) {
+        stats[row].samples = 0;
+        stats[row].innerRuns = 0;
+    }
+    for (int j = 0; j < count; j++) {
+        int e = 0;
+        while (engineList[e] != jobs[j].engine) e++;
+        int row = e * span + jobs[j].n - minDisks;
+        if (jobs[j].rep < 0) {
+            verified[row] = jobs[j].verified;
+        } else {
+            stats[row].sampleNs[jobs[j].rep] = jobs[j].ns;
+            if (jobs[j].innerRuns > stats[row].innerRuns) stats[row].innerRuns = jobs[j].innerRuns;
+            stats[row].samples++;
+        }
+    }
+    for (int row = 0; row < rows; row++) computeTimingStats(&stats[row]);
+    
+    free(jobs);
+    return pinned;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BATCH TESTING IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════
+#define BATCH_MIN_SAMPLES 5
+
+void runBatchExperiments(int maxDisks, int engine) {
+    if (maxDisks > 62) maxDisks = 62;      // 2^n - 1 must fit the 64-bit columns
+    clearScreen();
+    printf("\n");
+    char modeStr[32];
+    const char* color = engine == 0 ? BRIGHT_GREEN : engine == 1 ? BRIGHT_MAGENTA : BRIGHT_CYAN;
+    
+    int len = 0;
+    for (const char *c = engineLabel(engine); *c && len < 31; c++) {
+        modeStr[len++] = (*c >= 'a' && *c <= 'z') ? *c - 'a' + 'A' : *c;
+    }
+    modeStr[len] = '\0';
+    
+    printf("%s%s+=============================================================================+%s\n", BOLD, color, RESET);
+    printf("%s%s|               BATCH PERFORMANCE TEST (%-9s)                       |%s\n", BOLD, color, modeStr, RESET);
+    printf("%s%s+=============================================================================+%s\n", BOLD, color, RESET);
+    printf("\n");
+    
+    printf("%s%s  %-5s | %-20s | %-12s | %-12s | %-12s | %-10s | %-14s%s\n", BOLD, BRIGHT_CYAN,
+           "Disks", "Total Moves", "Min (us)", "Median (us)", "P95 (us)", "Stddev %", "Moves/Sec", RESET);
+    printSeparator(BRIGHT_BLACK);
+    
+    // Every (n, repetition) pair is one scheduler job
+    TimingStats *table = (TimingStats *)malloc(maxDisks * sizeof(TimingStats));
+    int *verified = (int *)malloc(maxDisks * sizeof(int));
+    long long sweepStart = hanoiNowNs();
+    int pinned = table && verified
+        ? batchSweep(&engine, 1, 1, maxDisks, BATCH_MIN_SAMPLES, 1, table, verified) : -1;
+    double sweepSeconds = (hanoiNowNs() - sweepStart) / 1e9;
+    
+    if (pinned < 0) {
+        printf("  %sOut of memory!%s\n", BRIGHT_RED, RESET);
+        free(table);
+        free(verified);
+        pressAnyKey();
+        return;
+    }
+    
+    for (int n = 1; n <= maxDisks; n++) {
+        long long expectedMoves = (long long)engineMoveCount(engine, n);
+        TimingStats *stats = &table[n - 1];
+        
+        double mps = (stats->medianNs > 0) ? expectedMoves / (stats->medianNs / 1e9) : 0.0;
+        double spread = (stats->meanNs > 0) ? 100.0 * stats->stddevNs / stats->meanNs : 0.0;
+        
+        printf("  %-5d | %-20lld | %-12.3f | %-12.3f | %-12.3f | %-10.2f | %-14.0f\n", 
+               n, expectedMoves, stats->minNs / 1e3, stats->medianNs / 1e3,
+               stats->p95Ns / 1e3, spread, mps);
+        
+        if (perfEnabled) {
+            PerfSample perf;
+            perfEngine(engine, n, stats, &perf);
+            printf("%s          ", BRIGHT_BLACK);
+            if (perf.cycles >= 0) printf("cycles %.3g  ", perf.cycles);
+            if (perf.instructions >= 0) printf("instr %.3g  ", perf.instructions);
+            if (perf.cycles > 0 && perf.instructions >= 0) printf("IPC %.2f  ", perf.instructions / perf.cycles);
+            if (perf.branchMisses >= 0) printf("br-miss %.3g  ", perf.branchMisses);
+            if (perf.l1dMisses >= 0) printf("L1d-miss %.3g  ", perf.l1dMisses);
+            if (perf.llcMisses >= 0) printf("LLC-miss %.3g  ", perf.llcMisses);
+            if (perf.cycles < 0) printf("(no hardware counters)  ");
+            else printf("(%s)  ", perf.counterScope);
+            if (perf.peakRssKb >= 0) printf("RSS %ld KB  ", perf.peakRssKb);
+            if (perf.allocations >= 0) printf("allocs %.1f", perf.allocations);
+            printf("%s\n", RESET);
+        }
+        fflush(stdout); // Ensure line prints immediately
+    }
+    
+    printSeparator(BRIGHT_BLACK);
+    
+    if (batchQuiet) {
+        printf("  %s* Scheduler:%s quiet, one job at a time on CPU %d%s, %.2f s\n",
+               BRIGHT_YELLOW, RESET, hanoiQuietCpu(), pinned ? "" : " (not pinned)", sweepSeconds);
+    } else {
+        printf("  %s* Scheduler:%s %d pinned workers, %.2f s\n",
+               BRIGHT_YELLOW, RESET, pinned, sweepSeconds);
+    }
+    
+    if (engines[engine].verify) {
+        int firstMismatch = 0;
+        for (int n = 1; n <= maxDisks && !firstMismatch; n++) {
+            if (!verified[n - 1]) firstMismatch = n;
+        }
+        if (firstMismatch) {
+            printf("  %s* Cross-check:%s %s%sMISMATCH at %d disks!%s\n",
+                   BRIGHT_YELLOW, RESET, BOLD, BRIGHT_RED, firstMismatch, RESET);
+        } else {
+            printf("  %s* Cross-check:%s %s%sfinal states match the stack engine for 1-%d disks%s\n",
+                   BRIGHT_YELLOW, RESET, BOLD, BRIGHT_GREEN, maxDisks, RESET);
+        }
+    }
+    free(table);
+    free(verified);
+    pressAnyKey();
+}
+
+void runEngineLab() {
+    int engine, disks;
+    
+    clearScreen();
+    printHeader();
+    printBox("ENGINE LAB", BRIGHT_CYAN);
+    printf("\n");
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        printf("  %s%d.%s %s%s%s\n", BRIGHT_CYAN, e + 1, RESET, BRIGHT_WHITE, engines[e].name, RESET);
+    }
+    printf("\n");
+    printSeparator(BRIGHT_BLACK);
+    printf("%s  Engine: %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%d", &engine) != 1 || engine < 1 || engine > ENGINE_COUNT) {
+        printf("\n%s  Warning: Invalid choice!%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    printf("%s  Max disks to test (e.g., 25): %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%d", &disks) != 1 || disks <= 0 || disks > 62) {
+        printf("\n%s  Warning: Invalid input! Please enter 1 to 62 disks.%s\n", BRIGHT_RED, RESET);
+        pressAnyKey();
+        return;
+    }
+    
+    if (engines[engine - 1].solve == hanoiSolveFrameStewart) {
+        printf("%s  Number of pegs (%d-%d): %s", BRIGHT_YELLOW, HANOI_FS_MIN_PEGS, HANOI_FS_MAX_PEGS, RESET);
+        if (scanf("%d", &hanoiFrameStewartPegs) != 1 || hanoiFrameStewartPegs < HANOI_FS_MIN_PEGS
+            || hanoiFrameStewartPegs > HANOI_FS_MAX_PEGS) {
+            hanoiFrameStewartPegs = 4;
+            printf("\n%s  Warning: Invalid peg count!%s\n", BRIGHT_RED, RESET);
+            pressAnyKey();
+            return;
+        }
+    }
+    printf("%s  Run mode (0 = all %d cores, 1 = quiet, one job at a time on CPU %d): %s",
+           BRIGHT_YELLOW, hanoiHardwareThreads(), hanoiQuietCpu(), RESET);
+    if (scanf("%d", &batchQuiet) != 1) batchQuiet = 0;
+    batchQuiet = batchQuiet != 0;
+    
+    printf("%s  Collect hardware counters and memory use? (1 = yes, 0 = no): %s", BRIGHT_YELLOW, RESET);
+    if (scanf("%d", &perfEnabled) != 1) perfEnabled = 0;
+    perfEnabled = perfEnabled != 0;
+    
+    if (engines[engine - 1].solve == hanoiSolveParallel) {
+        printf("%s  Worker threads (1-%d, 0 = all %d cores): %s", BRIGHT_YELLOW, HANOI_MAX_THREADS,
+               hanoiHardwareThreads(), RESET);
+        if (scanf("%d", &hanoiParallelThreads) != 1 || hanoiParallelThreads < 0 || hanoiParallelThreads > HANOI_MAX_THREADS) {
+            hanoiParallelThreads = 0;
+            printf("\n%s  Warning: Invalid thread count!%s\n", BRIGHT_RED, RESET);
+            pressAnyKey();
+            return;
+        }
+    }
+    runBatchExperiments(disks, engine - 1);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  MENU SYSTEMS
+// ═══════════════════════════════════════════════════════════
+void recursiveMenu() {
+    int choice;
+    int disks;
+    
+    while (1) {
+        clearScreen();
+        printHeader();
+        
+        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
+        printf("%s%s|                   RECURSIVE MODE                           |%s\n", BOLD, BRIGHT_GREEN, RESET);
+        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_GREEN, RESET);
+        printf("\n");
+        
+        printf("  %s1.%s %sCustom Test%s       - Choose any number of disks\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s2.%s %sVisualizer%s        - Launch graphical interface\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s3.%s %sStandard Tests%s    - Run 5, 10, 15, 20 disk tests\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s4.%s %sExplanation%s       - Learn how the algorithm works\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s5.%s %sBatch Test%s        - Run range 1-N (Table View)\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s0.%s %sBack%s              - Return to main menu\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        
+        printf("\n");
+        printSeparator(BRIGHT_BLACK);
+        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
+        
+        if (scanf("%d", &choice) != 1) {
+            while(getchar() != '\n');
+            choice = -1;
+        }
+        
+        switch (choice) {
+            case 1:
+                printf("%s  Number of disks: %s", BRIGHT_YELLOW, RESET);
+                if (scanf("%d", &disks) != 1 || disks <= 0) {
+                    printf("\n%s  Warning: Invalid input! Please enter a positive number.%s\n", 
+                           BRIGHT_RED, RESET);
+                    pressAnyKey();
+                } else if (disks > 30) {
+                    printf("\n%s  Warning: %d disks will take a very long time!%s\n", 
+                           BRIGHT_RED, disks, RESET);
+                    printf("%s     Continue anyway? (1=Yes, 0=No): %s", BRIGHT_YELLOW, RESET);
+                    int confirm;
+                    if (scanf("%d", &confirm) == 1 && confirm == 1) {
+                        runRecursiveTest(disks);
+                    }
+                } else {
+                    runRecursiveTest(disks);
+                }
+                break;
+                
+            case 2:
+                launchVisualizer();
+                break;
+                
+            case 3:
+                runRecursiveTest(5);
+                runRecursiveTest(10);
+                runRecursiveTest(15);
+                runRecursiveTest(20);
+                break;
+                
+            case 4:
+                showRecursiveExplanation();
+                break;
+
+            case 5:
+                printf("%s  Max disks to test (e.g., 25): %s", BRIGHT_YELLOW, RESET);
+                if (scanf("%d", &disks) == 1 && disks > 0) {
+                    if (disks > 30) {
+                         printf("\n%s  Warning: %d disks will take a long time! Continue? (1=Yes): %s", BRIGHT_RED, disks, RESET);
+                         int c; scanf("%d", &c);
+                         if (c!=1) break;
+                    }
+                    runBatchExperiments(disks, 0);
+                }
+                break;
+                
+            case 0:
+                return;
+                
+            default:
+                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
+                       BRIGHT_RED, RESET);
+                pressAnyKey();
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+//  ITERATIVE MENU
+// ═══════════════════════════════════════════════════════════
+void iterativeMenu() {
+    int choice;
+    int disks;
+    
+    while (1) {
+        clearScreen();
+        printHeader();
+        
+        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+        printf("%s%s|                   ITERATIVE MODE                           |%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+        printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_MAGENTA, RESET);
+        printf("\n");
+        
+        printf("  %s1.%s %sCustom Test%s       - Choose any number of disks\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s3.%s %sStandard Tests%s    - Run 5, 10, 15, 20 disk tests\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s4.%s %sExplanation%s       - Learn how the algorithm works\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s5.%s %sBatch Test%s        - Run range 1-N (Table View)\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s6.%s %sSeek Move%s         - Show move k without simulating\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s7.%s %sJump to State%s     - Show the pegs after k moves\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s8.%s %sSolve Any State%s   - Shortest path between two setups\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s9.%s %sResume Run%s        - Continue an interrupted test from its checkpoint\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s0.%s %sBack%s              - Return to main menu\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        
+        printf("\n");
+        printSeparator(BRIGHT_BLACK);
+        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
+        
+        if (scanf("%d", &choice) != 1) {
+            while(getchar() != '\n');
+            choice = -1;
+        }
+        
+        switch (choice) {
+            case 1:
+                printf("%s  Number of disks: %s", BRIGHT_YELLOW, RESET);
+                if (scanf("%d", &disks) != 1 || disks <= 0) {
+                    printf("\n%s  Warning: Invalid input! Please enter a positive number.%s\n", 
+                           BRIGHT_RED, RESET);
+                    pressAnyKey();
+                } else {
+                    runIterativeTest(disks, 0);
+                }
+                break;
+                
+            case 3:
+                runIterativeTest(5, 0);
+                runIterativeTest(10, 0);
+                runIterativeTest(15, 0);
+                runIterativeTest(20, 0);
+                break;
+                
+            case 4:
+                showIterativeExplanation();
+                break;
+
+            case 5:
+                printf("%s  Max disks to test (e.g., 25): %s", BRIGHT_YELLOW, RESET);
+                if (scanf("%d", &disks) == 1 && disks > 0) {
+                    if (disks > 30) {
+                         printf("\n%s  Warning: %d disks will take a long time! Continue? (1=Yes): %s", BRIGHT_RED, disks, RESET);
+                         int c; scanf("%d", &c);
+                         if (c!=1) break;
+                    }
+                    runBatchExperiments(disks, 1);
+                }
+                break;
+                
+            case 6:
+                runSeekMove();
+                break;
+                
+            case 7:
+                runJumpToState();
+                break;
+                
+            case 8:
+                runSolveBetween();
+                break;
+                
+            case 9:
+                printf("%s  Number of disks: %s", BRIGHT_YELLOW, RESET);
+                if (scanf("%d", &disks) != 1 || disks <= 0) {
+                    printf("\n%s  Warning: Invalid input! Please enter a positive number.%s\n", 
+                           BRIGHT_RED, RESET);
+                    pressAnyKey();
+                } else {
+                    runIterativeTest(disks, 1);
+                }
+                break;
+                
+            case 0:
+                return;
+                
+            default:
+                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
+                       BRIGHT_RED, RESET);
+                pressAnyKey();
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+//  BENCHMARK REGRESSION SUITE
+// ═══════════════════════════════════════════════════════════
+// A fixed matrix (SUITE_MATRIX: each engine at its own three disk counts)
+// is measured and optionally saved as a baseline:
+//   hanoi-baseline 1
+//   <engine label> <n> <samples> <mean_ns> <stddev_ns> <median_ns>
+// A later run compared against it flags an entry as a regression when the
+// mean time grew by more than the threshold and Welch's t-test rejects
+// equal means at SUITE_ALPHA.
+#define SUITE_MIN_SAMPLES 10
+#define SUITE_ALPHA       0.01
+#define SUITE_MAX_ENTRIES 256
+
+#define SUITE_SIZES       3
+
+// Sizes give each engine roughly 2^12, 2^18 and 2^22 moves, except the
+// kernel (baked-in tables only) and framestewart (counts depend on the
+// peg count, which is part of its label). Engines added to the registry
+// join the suite only once they get a row here, so baselines stay
+// comparable.
+typedef struct {
+    const char *engine;
+    int disks[SUITE_SIZES];
+} SuiteRow;
+
+static const SuiteRow SUITE_MATRIX[] = {
+    { "recursive",    { 12, 18, 22 } },
+    { "iterative",    { 12, 18, 22 } },
+    { "bitboard",     { 12, 18, 22 } },
+    { "framestewart", { 12, 18, 22 } },
+    { "block",        { 12, 18, 22 } },
+    { "kernel",       { 12, 14, 16 } },
+    { "parallel",     { 12, 18, 22 } },
+    { "cursor",       { 12, 18, 22 } },
+    { "simd",         { 12, 18, 22 } },
+    { "adjacent",     {  8, 11, 14 } },
+    { "cyclic",       {  8, 12, 15 } },
+};
+#define SUITE_ROWS ((int)(sizeof(SUITE_MATRIX) / sizeof(SUITE_MATRIX[0])))
+
+typedef struct {
+    char engine[48];
+    int n;
+    int samples;
+    double meanNs;
+    double stddevNs;
+    double medianNs;
+} BaselineEntry;
+
+// Returns the number of entries read, or -1 when the file is not a baseline
+int loadBaseline(const char *path, BaselineEntry *entries, int max) {
+    FILE *f = fopen(path, "r");
+    int version, count = 0;
+    
+    if (!f) return -1;
+    if (fscanf(f, "hanoi-baseline %d", &version) != 1 || version != 1) {
+        fclose(f);
+        return -1;
+    }
+    while (count < max) {
+        BaselineEntry *e = &entries[count];
+        if (fscanf(f, "%47s %d %d %lf %lf %lf", e->engine, &e->n, &e->samples,
+                   &e->meanNs, &e->stddevNs, &e->medianNs) != 6) break;
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+int saveBaseline(const char *path, const BaselineEntry *entries, int count) {
+    FILE *f = fopen(path, "w");
+    if (!f) return 0;
+    fprintf(f, "hanoi-baseline 1\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(f, "%s %d %d %.3f %.3f %.3f\n", entries[i].engine, entries[i].n, entries[i].samples,
+                entries[i].meanNs, entries[i].stddevNs, entries[i].medianNs);
+    }
+    return fclose(f) == 0;
+}
+
+// Welch's unequal-variance t-test between two sets of timing samples given
+// as mean, standard deviation and count. p is the two-sided p-value.
+typedef struct {
+    double t;
+    double df;
+    double p;
+} WelchResult;
+
+// Continued fraction for the regularized incomplete beta function
+double betaContinuedFraction(double a, double b, double x) {
+    double c = 1.0, d = 1.0 - (a + b) * x / (a + 1.0);
+    if (fabs(d) < 1e-300) d = 1e-300;
+    d = 1.0 / d;
+    double h = d;
+    
+    for (int m = 1; m <= 200; m++) {
+        double m2 = 2.0 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+        d = 1.0 + aa * d;
+        if (fabs(d) < 1e-300) d = 1e-300;
+        c = 1.0 + aa / c;
+        if (fabs(c) < 1e-300) c = 1e-300;
+        d = 1.0 / d;
+        h *= d * c;
+        
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+        d = 1.0 + aa * d;
+        if (fabs(d) < 1e-300) d = 1e-300;
+        c = 1.0 + aa / c;
+        if (fabs(c) < 1e-300) c = 1e-300;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (fabs(delta - 1.0) < 1e-12) break;
+    }
+    return h;
+}
+
+double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) return front * betaContinuedFraction(a, b, x) / a;
+    return 1.0 - front * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+void welchTest(double mean0, double sd0, int n0, double mean1, double sd1, int n1, WelchResult *r) {
+    double v0 = sd0 * sd0 / n0, v1 = sd1 * sd1 / n1;
+    double se = sqrt(v0 + v1);
+    
+    if (n0 < 2 || n1 < 2 || se <= 0.0) {
+        r->t = 0.0;
+        r->df = 0.0;
+        r->p = (mean0 == mean1) ? 1.0 : 0.0;
+        return;
+    }
+    r->t = (mean1 - mean0) / se;
+    r->df = (v0 + v1) * (v0 + v1) / (v0 * v0 / (n0 - 1) + v1 * v1 / (n1 - 1));
+    r->p = incompleteBeta(r->df / 2.0, 0.5, r->df / (r->df + r->t * r->t));
+}
+
+// Exit status 1 when any entry regressed, 2 on a bad baseline file
+int runSuite(int repeats, int json, const char *baselinePath, const char *savePath, double threshold) {
+    BaselineEntry *baseline = NULL, *results = NULL;
+    int baselineCount = 0, resultCount = 0, regressions = 0;
+    
+    if (repeats < SUITE_MIN_SAMPLES) repeats = SUITE_MIN_SAMPLES;
+    baseline = (BaselineEntry *)malloc(SUITE_MAX_ENTRIES * sizeof(BaselineEntry));
+    results = (BaselineEntry *)malloc(SUITE_MAX_ENTRIES * sizeof(BaselineEntry));
+    TimingStats *stats = (TimingStats *)malloc(sizeof(TimingStats));
+    
+    if (baselinePath) {
+        baselineCount = loadBaseline(baselinePath, baseline, SUITE_MAX_ENTRIES);
+        if (baselineCount < 0) {
+            fprintf(stderr, "Cannot read baseline '%s'\n", baselinePath);
+            free(baseline);
+            free(results);
+            free(stats);
+            return 2;
+        }
+    }
+    
+    if (!json) {
+        printf("engine,n,samples,median_ns,mean_ns,stddev_ns,moves_per_sec%s\n",
+               baselinePath ? ",baseline_mean_ns,change_pct,t,df,p_value,verdict" : "");
+    }
+    
+    for (int row = 0; row < SUITE_ROWS; row++) {
+        int e = findEngine(SUITE_MATRIX[row].engine);
+        if (e < 0) continue;
+        
+        for (int d = 0; d < SUITE_SIZES; d++) {
+            int n = SUITE_MATRIX[row].disks[d];
+            measureEngine(e, n, repeats, stats);
+            
+            BaselineEntry *r = &results[resultCount++];
+            snprintf(r->engine, sizeof(r->engine), "%s", engineLabel(e));
+            r->n = n;
+            r->samples = stats->samples;
+            r->meanNs = stats->meanNs;
+            r->stddevNs = stats->stddevNs;
+            r->medianNs = stats->medianNs;
+            double mps = (r->medianNs > 0) ? engineMoveCount(e, n) / (r->medianNs / 1e9) : 0.0;
+            
+            if (json) {
+                printf("{\"engine\":\"%s\",\"n\":%d,\"samples\":%d,\"median_ns\":%.1f,\"mean_ns\":%.1f,"
+                       "\"stddev_ns\":%.1f,\"moves_per_sec\":%.0f",
+                       r->engine, n, r->samples, r->medianNs, r->meanNs, r->stddevNs, mps);
+            } else {
+                printf("%s,%d,%d,%.1f,%.1f,%.1f,%.0f", r->engine, n, r->samples,
+                       r->medianNs, r->meanNs, r->stddevNs, mps);
+            }
+            
+            if (baselinePath) {
+                const BaselineEntry *b = NULL;
+                for (int i = 0; i < baselineCount && !b; i++) {
+                    if (baseline[i].n == n && strcmp(baseline[i].engine, r->engine) == 0) b = &baseline[i];
+                }
+                
+                if (!b) {
+                    if (json) printf(",\"verdict\":\"new\"");
+                    else printf(",,,,,,new");
+                } else {
+                    WelchResult w;
+                    welchTest(b->meanNs, b->stddevNs, b->samples, r->meanNs, r->stddevNs, r->samples, &w);
+                    double change = (b->meanNs > 0) ? 100.0 * (r->meanNs - b->meanNs) / b->meanNs : 0.0;
+                    const char *verdict = "same";
+                    if (w.p < SUITE_ALPHA && change > threshold) {
+                        verdict = "regression";
+                        regressions++;
+                    } else if (w.p < SUITE_ALPHA && change < -threshold) {
+                        verdict = "improvement";
+                    }
+                    
+                    if (json) {
+                        printf(",\"baseline_mean_ns\":%.1f,\"change_pct\":%.2f,\"t\":%.3f,\"df\":%.1f,"
+                               "\"p_value\":%.3g,\"verdict\":\"%s\"", b->meanNs, change, w.t, w.df, w.p, verdict);
+                    } else {
+                        printf(",%.1f,%.2f,%.3f,%.1f,%.3g,%s", b->meanNs, change, w.t, w.df, w.p, verdict);
+                    }
+                }
+            }
+            printf(json ? "}\n" : "\n");
+            fflush(stdout);
+        }
+    }
+    
+    if (savePath && !saveBaseline(savePath, results, resultCount)) {
+        fprintf(stderr, "Cannot write baseline '%s'\n", savePath);
+    }
+    if (baselinePath) {
+        fprintf(stderr, "%d regression%s beyond %.1f%% (p < %.2f)\n",
+                regressions, regressions == 1 ? "" : "s", threshold, SUITE_ALPHA);
+    }
+    
+    free(baseline);
+    free(results);
+    free(stats);
+    return regressions ? 1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════
+//  HEADLESS BENCHMARK MODE
+// ═══════════════════════════════════════════════════════════
+void printUsage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  Without options the interactive menu is started.\n\n");
+    fprintf(stderr, "Benchmark options:\n");
+    fprintf(stderr, "  --engine NAME     engine to run (");
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        fprintf(stderr, "%s%s", e ? ", " : "", engines[e].name);
+    }
+    fprintf(stderr, "), or all\n");
+    fprintf(stderr, "                    to sweep every engine; default recursive\n");
+    fprintf(stderr, "  --min N           smallest disk count, default 1\n");
+    fprintf(stderr, "  --max N           largest disk count, default 20\n");
+    fprintf(stderr, "  --repeat R        minimum timed samples per disk count, default 5\n");
+    fprintf(stderr, "  --format FMT      csv (default) or json (one object per line)\n");
+    fprintf(stderr, "  --check           cross-check final states against the stack engine\n");
+    fprintf(stderr, "  --perf            add per-solve hardware counters (Linux perf_event_open),\n");
+    fprintf(stderr, "                    peak RSS and allocation counts to every row; counters\n");
+    fprintf(stderr, "                    cover the calling thread and the workers it starts\n");
+    fprintf(stderr, "  --pegs P          peg count for the framestewart engine (3-8), default 4\n");
+    fprintf(stderr, "  --simd PATH       path of the simd engine: avx2, sse4.1, scalar or auto\n");
+    fprintf(stderr, "                    (default, the widest this CPU supports)\n");
+    fprintf(stderr, "  --workers W       spread (engine, n, repetition) jobs over W pinned workers,\n");
+    fprintf(stderr, "                    0 = one per core; each job is one calibrated sample\n");
+    fprintf(stderr, "  --quiet           scheduled sweep, one job at a time on an isolated core\n");
+    fprintf(stderr, "  --help            show this message\n\n");
+    fprintf(stderr, "Regression suite (a fixed engine and disk-count matrix):\n");
+    fprintf(stderr, "  --suite           run the suite (at least %d samples per entry)\n", SUITE_MIN_SAMPLES);
+    fprintf(stderr, "  --save-baseline F store the results in F\n");
+    fprintf(stderr, "  --baseline F      compare with F using Welch's t-test; exit status 1 when\n");
+    fprintf(stderr, "                    any entry is slower by more than the threshold\n");
+    fprintf(stderr, "  --threshold PCT   regression threshold in percent of the mean, default 5\n\n");
+    fprintf(stderr, "Queries (printed in --format):\n");
+    fprintf(stderr, "  --move N K        disk and pegs of move K of the N-disk solution (N <= %d)\n", HANOI_MAX_DISKS);
+    fprintf(stderr, "  --count N         optimal move count for N disks\n");
+    fprintf(stderr, "  --variant V       adjacent (moves between neighbouring pegs only, up to %d\n", HANOI_ADJACENT_MAX_DISKS);
+    fprintf(stderr, "                    disks) or cyclic (A -> B -> C -> A only, up to %d disks):\n", HANOI_CYCLIC_MAX_DISKS);
+    fprintf(stderr, "                    --move and --count then answer for that variant\n");
+    fprintf(stderr, "  --state N K       configuration after the first K moves\n");
+    fprintf(stderr, "  --rank CONFIG     move index of a configuration on the optimal path\n");
+    fprintf(stderr, "                    CONFIG has one peg letter per disk, smallest first (e.g. AAB)\n");
+    fprintf(stderr, "  --solve FROM TO   shortest move sequence between two configurations\n");
+    fprintf(stderr, "  --distances FILE  distance for every \"START TARGET\" line of FILE (- = stdin,\n");
+    fprintf(stderr, "                    N <= %d), one answer per line, in parallel on --threads\n", HANOI_ORACLE_MAX_DISKS);
+    fprintf(stderr, "  --fs-count N P    Frame-Stewart move count for N disks on P pegs (any N)\n\n");
+    fprintf(stderr, "State-space search:\n");
+    fprintf(stderr, "  --bfs N           parallel BFS over all 3^N configurations (N <= %d)\n", HANOI_BFS_MAX_DISKS);
+    fprintf(stderr, "  --from CONFIG     BFS start configuration, default all disks on A\n");
+    fprintf(stderr, "  --to CONFIG       also report the exact distance to CONFIG\n");
+    fprintf(stderr, "  --threads T,...   worker threads, default all cores; the parallel engine\n");
+    fprintf(stderr, "                    benchmark prints one row per listed thread count\n");
+    fprintf(stderr, "  --count-only      with --solve, print only the length (otherwise it goes\n");
+    fprintf(stderr, "                    to stderr and stdout holds only the moves)\n\n");
+    fprintf(stderr, "Long iterative runs:\n");
+    fprintf(stderr, "  --iterate N       solve N disks with the stack engine, checkpointing every 30 s\n");
+    fprintf(stderr, "                    and on Ctrl+C (exit status 3 when interrupted)\n");
+    fprintf(stderr, "  --checkpoint FILE checkpoint file, default hanoi-N.ckpt\n");
+    fprintf(stderr, "  --resume          continue from the checkpoint instead of move 1\n");
+    fprintf(stderr, "  --range N A B     execute only moves A+1..B of an N-disk solve (N <= %d),\n", HANOI_MAX_DISKS);
+    fprintf(stderr, "                    starting from the configuration after move A\n\n");
+    fprintf(stderr, "Move-stream validation (parallel, uses --threads, --from and --to):\n");
+    fprintf(stderr, "  --validate N SRC  check every move of SRC for legality and the final state;\n");
+    fprintf(stderr, "                    SRC is an engine (block, kernel, cursor, simd, recursive,\n");
+    fprintf(stderr, "                    parallel), a trace file (N is read from it), a step,disk,from,to\n");
+    fprintf(stderr, "                    text file, or - for text on stdin\n\n");
+    fprintf(stderr, "Move traces (2 bits per move plus a block index):\n");
+    fprintf(stderr, "  --trace-write N FILE        write the N-disk solution of --engine\n");
+    fprintf(stderr, "                              (recursive or iterative) to FILE\n");
+    fprintf(stderr, "  --trace-read FILE K COUNT   print COUNT moves starting at move K (1-based)\n\n");
+    fprintf(stderr, "Visualizer server (not on Windows):\n");
+    fprintf(stderr, "  --serve PORT      serve dist/ and the /api/moves, /api/state endpoints\n");
+    fprintf(stderr, "  --root DIR        directory to serve instead of dist\n\n");
+    fprintf(stderr, "Solver daemon (not on Windows):\n");
+    fprintf(stderr, "  --daemon PATH     answer binary solve, count, move and distance requests on\n");
+    fprintf(stderr, "                    the Unix socket PATH (e.g. %s) until SIGINT or SIGTERM;\n", DAEMON_SOCKET);
+    fprintf(stderr, "                    large batches are computed on --threads\n");
+    fprintf(stderr, "  --cache-mb M      size of its result and move-block cache, default %d\n", DAEMON_CACHE_MB);
+}
+
+// variant < 0 is the classic puzzle
+int runMoveQuery(int n, HanoiMoveIndex k, int variant, int json) {
+    char kText[40];
+    HanoiMove m;
+    
+    if (variant >= 0) {
+        if (k < 1 || k > hanoiVariantMoveCount(variant, n)) {
+            fprintf(stderr, "Move query needs 1 <= N <= %d and 1 <= K <= the %s move count\n",
+                    hanoiVariantMaxDisks(variant), hanoiVariantName(variant));
+            return 2;
+        }
+        m = hanoiVariantKthMove(variant, n, k);
+    } else if (n < 1 || n > HANOI_MAX_DISKS || k < 1 || k > ((HanoiMoveIndex)1 << n) - 1) {
+        fprintf(stderr, "Move query needs 1 <= N <= %d and 1 <= K <= 2^N - 1\n", HANOI_MAX_DISKS);
+        return 2;
+    } else {
+        m = hanoiKthMove128(n, k);
+    }
+    hanoiFormatMoveIndex(k, kText);
+    if (json) {
+        printf("{\"n\":%d,\"k\":%s,\"disk\":%d,\"from\":\"%c\",\"to\":\"%c\"}\n",
+               n, kText, m.disk, 'A' + m.from, 'A' + m.to);
+    } else {
+        printf("n,k,disk,from,to\n%d,%s,%d,%c,%c\n", n, kText, m.disk, 'A' + m.from, 'A' + m.to);
+    }
+    return 0;
+}
+
+// Exact optimal move count of the classic puzzle or a restricted variant
+int runCountQuery(int n, int variant, int json) {
+    int maxDisks = variant >= 0 ? hanoiVariantMaxDisks(variant) : HANOI_MAX_DISKS;
+    char text[40];
+    
+    if (n < 1 || n > maxDisks) {
+        fprintf(stderr, "Count query needs 1 <= N <= %d\n", maxDisks);
+        return 2;
+    }
+    
+    hanoiFormatMoveIndex(variant >= 0 ? hanoiVariantMoveCount(variant, n) : ((HanoiMoveIndex)1 << n) - 1, text);
+    if (json) printf("{\"n\":%d,\"variant\":\"%s\",\"moves\":%s}\n", n, hanoiVariantName(variant), text);
+    else printf("n,variant,moves\n%d,%s,%s\n", n, hanoiVariantName(variant), text);
+    return 0;
+}
+
+int runStateQuery(int n, HanoiMoveIndex k, int json) {
+    int pegOf[HANOI_MAX_DISKS + 1];
+    char config[HANOI_MAX_DISKS + 1];
+    char kText[40];
+    
+    if (n < 1 || n > HANOI_MAX_DISKS || k > ((HanoiMoveIndex)1 << n) - 1) {
+        fprintf(stderr, "State query needs 1 <= N <= %d and 0 <= K <= 2^N - 1\n", HANOI_MAX_DISKS);
+        return 2;
+    }
+    
+    hanoiStateAfter128(n, k, pegOf);
+    hanoiFormatConfig(n, pegOf, config);
+    hanoiFormatMoveIndex(k, kText);
+    if (json) printf("{\"n\":%d,\"k\":%s,\"config\":\"%s\"}\n", n, kText, config);
+    else printf("n,k,config\n%d,%s,%s\n", n, kText, config);
+    return 0;
+}
+
+int runRankQuery(const char *text, int json) {
+    int pegOf[HANOI_MAX_DISKS + 1];
+    HanoiMoveIndex k;
+    char kText[40];
+    
+    int n = hanoiParseConfig(text, pegOf, HANOI_MAX_DISKS);
+    if (n < 0) {
+        fprintf(stderr, "Configuration must be 1 to %d peg letters A, B or C\n", HANOI_MAX_DISKS);
+        return 2;
+    }
+    
+    if (!hanoiStateIndex128(n, pegOf, &k)) {
+        if (json) printf("{\"n\":%d,\"config\":\"%s\",\"on_path\":false}\n", n, text);
+        else printf("n,config,k\n%d,%s,\n", n, text);
+        return 1;
+    }
+    
+    hanoiFormatMoveIndex(k, kText);
+    if (json) printf("{\"n\":%d,\"config\":\"%s\",\"on_path\":true,\"k\":%s}\n", n, text, kText);
+    else printf("n,config,k\n%d,%s,%s\n", n, text, kText);
+    return 0;
+}
+
+// Execute moves a+1 .. b of the n-disk solution; exit status 3 when interrupted
+int runRange(int n, HanoiMoveIndex a, HanoiMoveIndex b, int json) {
+    RangeRun run;
+    char aText[40], bText[40], doneText[40];
+    
+    if (n < 1 || n > HANOI_MAX_DISKS || a > b || b > ((HanoiMoveIndex)1 << n) - 1) {
+        fprintf(stderr, "Range needs 1 <= N <= %d and 0 <= A <= B <= 2^N - 1\n", HANOI_MAX_DISKS);
+        return 2;
+    }
+    
+    hanoiRunRange(n, a, b, &run);
+    
+    const char *status = !run.finalStateOk ? "error" : run.interrupted ? "interrupted" : "complete";
+    double mps = (run.seconds > 0) ? (double)run.done / run.seconds : 0.0;
+    hanoiFormatMoveIndex(a, aText);
+    hanoiFormatMoveIndex(b, bText);
+    hanoiFormatMoveIndex(run.done, doneText);
+    if (json) {
+        printf("{\"n\":%d,\"first\":%s,\"last\":%s,\"done\":%s,\"seconds\":%.6f,\"moves_per_sec\":%.0f,"
+               "\"config\":\"%s\",\"status\":\"%s\"}\n",
+               n, aText, bText, doneText, run.seconds, mps, run.config, status);
+    } else {
+        printf("n,first,last,done,seconds,moves_per_sec,config,status\n");
+        printf("%d,%s,%s,%s,%.6f,%.0f,%s,%s\n", n, aText, bText, doneText, run.seconds, mps, run.config, status);
+    }
+    if (!run.finalStateOk) return 1;
+    return run.interrupted ? 3 : 0;
+}
+
+typedef struct {
+    unsigned long long step;
+    int json;
+} SolveOutput;
+
+void writeSolveMove(const HanoiMove *m, void *ctx) {
+    SolveOutput *out = (SolveOutput *)ctx;
+    out->step++;
+    if (out->json) {
+        printf("{\"step\":%llu,\"disk\":%d,\"from\":\"%c\",\"to\":\"%c\"}\n",
+               out->step, m->disk, 'A' + m->from, 'A' + m->to);
+    } else {
+        printf("%llu,%d,%c,%c\n", out->step, m->disk, 'A' + m->from, 'A' + m->to);
+    }
+}
+
+int runSolveQuery(const char *startText, const char *targetText, int countOnly, int json) {
+    int start[64], target[64];
+    
+    int n = hanoiParseConfig(startText, start, 63);
+    if (n < 0 || hanoiParseConfig(targetText, target, 63) != n) {
+        fprintf(stderr, "Start and target must be configurations with the same number of disks\n");
+        return 2;
+    }
+    
+    // stdout carries one schema: the summary row with --count-only, the
+    // moves otherwise (the summary then goes to stderr)
+    unsigned long long length = hanoiSolveBetween(n, start, target, NULL, NULL);
+    if (countOnly && json) {
+        printf("{\"n\":%d,\"start\":\"%s\",\"target\":\"%s\",\"length\":%llu}\n",
+               n, startText, targetText, length);
+        return 0;
+    }
+    if (countOnly) {
+        printf("n,start,target,length\n%d,%s,%s,%llu\n", n, startText, targetText, length);
+        return 0;
+    }
+    fprintf(stderr, "%s -> %s: %llu move%s (%d disks)\n", startText, targetText, length,
+            length == 1 ? "" : "s", n);
+    
+    static char buffer[1 << 16];
+    setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+    
+    SolveOutput out = { 0, json };
+    if (!json) printf("step,disk,from,to\n");
+    hanoiSolveBetween(n, start, target, writeSolveMove, &out);
+    fflush(stdout);
+    return 0;
+}
+
+// Batch distance oracle; answers go to stdout, the summary to stderr
+int runDistanceOracle(const char *source, int threads, int json) {
+    HanoiOracleStats stats;
+    FILE *in = strcmp(source, "-") == 0 ? stdin : fopen(source, "r");
+    
+    if (!in) {
+        fprintf(stderr, "Cannot open '%s'\n", source);
+        return 1;
+    }
+    
+    long long t0 = hanoiNowNs();
+    int ok = hanoiDistanceOracle(in, stdout, threads, json, &stats);
+    double seconds = (hanoiNowNs() - t0) / 1e9;
+    if (in != stdin) fclose(in);
+    
+    if (!ok) {
+        fprintf(stderr, "Distance oracle stopped: read or write error, or out of memory\n");
+        return 1;
+    }
+    fprintf(stderr, "Answered %llu queries on %d threads in %.3f s (%.0f queries/sec)",
+            stats.queries, stats.threads, seconds, seconds > 0 ? stats.queries / seconds : 0.0);
+    if (stats.invalid) fprintf(stderr, ", %llu malformed (first on line %llu)", stats.invalid, stats.firstInvalid);
+    fprintf(stderr, "\n");
+    return stats.invalid ? 1 : 0;
+}
+
+// Prints value, or an empty CSV field / JSON null when it is unavailable
+void printPerfField(const char *name, double value, const char *format, int json) {
+    if (json) {
+        printf(",\"%s\":", name);
+        if (value >= 0) printf(format, value);
+        else printf("null");
+    } else {
+        printf(",");
+        if (value >= 0) printf(format, value);
+    }
+}
+
+// Per-solve counters, in the column order of perfColumns
+void printBenchPerf(const PerfSample *perf, int json) {
+    double ipc = (perf->cycles > 0 && perf->instructions >= 0) ? perf->instructions / perf->cycles : -1;
+    printPerfField("cycles", perf->cycles, "%.0f", json);
+    printPerfField("instructions", perf->instructions, "%.0f", json);
+    printPerfField("ipc", ipc, "%.3f", json);
+    printPerfField("branch_misses", perf->branchMisses, "%.0f", json);
+    printPerfField("l1d_misses", perf->l1dMisses, "%.0f", json);
+    printPerfField("llc_misses", perf->llcMisses, "%.0f", json);
+    printPerfField("peak_rss_kb", (double)perf->peakRssKb, "%.0f", json);
+    printPerfField("allocations", perf->allocations, "%.1f", json);
+    if (json && perf->counterScope) printf(",\"counter_scope\":\"%s\"", perf->counterScope);
+    else if (json) printf(",\"counter_scope\":null");
+    else printf(",%s", perf->counterScope ? perf->counterScope : "");
+}
+
+void printBenchRow(const char *engineName, int n, long long moves, const TimingStats *stats,
+                   const PerfSample *perf, const char *check, int json) {
+    double nsPerMove = stats->medianNs / moves;
+    double mps = (stats->medianNs > 0) ? moves / (stats->medianNs / 1e9) : 0.0;
+    
+    if (json) {
+        printf("{\"engine\":\"%s\",\"n\":%d,\"moves\":%lld,\"samples\":%d,"
+               "\"min_ns\":%.1f,\"median_ns\":%.1f,\"p95_ns\":%.1f,\"stddev_ns\":%.1f,"
+               "\"ns_per_move\":%.3f,\"moves_per_sec\":%.0f",
+               engineName, n, moves, stats->samples,
+               stats->minNs, stats->medianNs, stats->p95Ns, stats->stddevNs, nsPerMove, mps);
+        if (perf) printBenchPerf(perf, json);
+        if (check) printf(",\"check\":\"%s\"", check);
+        printf("}\n");
+    } else {
+        printf("%s,%d,%lld,%d,%.1f,%.1f,%.1f,%.1f,%.3f,%.0f",
+               engineName, n, moves, stats->samples,
+               stats->minNs, stats->medianNs, stats->p95Ns, stats->stddevNs, nsPerMove, mps);
+        if (perf) printBenchPerf(perf, json);
+        if (check) printf(",%s", check);
+        printf("\n");
+    }
+}
+
+// Thread counts such as "1,2,4,8"; returns how many were read, 0 on error
+int parseThreadList(const char *text, int *list, int max) {
+    int count = 0;
+    char item[16];
+    
+    while (*text) {
+        int len = 0;
+        while (text[len] && text[len] != ',') len++;
+        if (len == 0 || len >= (int)sizeof(item) || count == max) return 0;
+        memcpy(item, text, len);
+        item[len] = '\0';
+        if (!parseIntArg(item, &list[count]) || list[count] < 1 || list[count] > HANOI_MAX_THREADS) return 0;
+        count++;
+        text += len;
+        if (*text == ',' && *++text == '\0') return 0;
+    }
+    return count;
+}
+
+// The parallel engine gets one row per entry of threadList for every n
+int runHeadlessBenchmark(int engine, int minDisks, int maxDisks, int repeats, int json, int check,
+                         const int *threadList, int threadCount) {
+    if (!json) {
+        printf("engine,n,moves,samples,min_ns,median_ns,p95_ns,stddev_ns,ns_per_move,moves_per_sec%s%s\n",
+               perfEnabled ? ",cycles,instructions,ipc,branch_misses,l1d_misses,llc_misses,peak_rss_kb,allocations,counter_scope" : "",
+               check ? ",check" : "");
+    }
+    
+    TimingStats *stats = (TimingStats *)malloc(sizeof(TimingStats));
+    int failed = 0;
+    
+    if (engines[engine].solve != hanoiSolveParallel) threadCount = 1;
+    
+    for (int n = minDisks; n <= maxDisks; n++) {
+        for (int t = 0; t < threadCount; t++) {
+            hanoiParallelThreads = threadList[t];
+            long long moves = (long long)engineMoveCount(engine, n);
+            measureEngine(engine, n, repeats, stats);
+            
+            PerfSample perf;
+            if (perfEnabled) perfEngine(engine, n, stats, &perf);
+            
+            const char *status = NULL;
+            if (check) {
+                if (!engines[engine].verify) status = "n/a";
+                else if (engines[engine].verify(n)) status = "ok";
+                else { status = "mismatch"; failed = 1; }
+            }
+            
+            printBenchRow(engineLabel(engine), n, moves, stats, perfEnabled ? &perf : NULL, status, json);
+            fflush(stdout);
+        }
+    }
+    
+    free(stats);
+    return failed;
+}
+
+// Same rows through the batch scheduler; engine -1 sweeps every engine
+int runScheduledBenchmark(int engine, int minDisks, int maxDisks, int repeats, int json, int check) {
+    int engineList[ENGINE_COUNT];
+    int engineCount = 0;
+    int span = maxDisks - minDisks + 1;
+    int failed = 0;
+    
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        if (engine < 0 || e == engine) engineList[engineCount++] = e;
+    }
+    
+    TimingStats *table = (TimingStats *)malloc((size_t)engineCount * span * sizeof(TimingStats));
+    int *verified = (int *)malloc((size_t)engineCount * span * sizeof(int));
+    long long start = hanoiNowNs();
+    int pinned = table && verified
+        ? batchSweep(engineList, engineCount, minDisks, maxDisks, repeats, check, table, verified) : -1;
+    
+    if (pinned < 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(table);
+        free(verified);
+        return 2;
+    }
+    fprintf(stderr, "Scheduled sweep: %s, %d pinned worker%s, %.2f s\n",
+            batchQuiet ? "quiet" : "all cores", pinned, pinned == 1 ? "" : "s", (hanoiNowNs() - start) / 1e9);
+    
+    if (!json) {
+        printf("engine,n,moves,samples,min_ns,median_ns,p95_ns,stddev_ns,ns_per_move,moves_per_sec%s%s\n",
+               perfEnabled ? ",cycles,instructions,ipc,branch_misses,l1d_misses,llc_misses,peak_rss_kb,allocations,counter_scope" : "",
+               check ? ",check" : "");
+    }
+    
+    for (int e = 0; e < engineCount; e++) {
+        for (int n = minDisks; n <= maxDisks; n++) {
+            int row = e * span + n - minDisks;
+            long long moves = (long long)engineMoveCount(engineList[e], n);
+            
+            // Counters are read on the calling thread, after the sweep
+            PerfSample perf;
+            if (perfEnabled) perfEngine(engineList[e], n, &table[row], &perf);
+            
+            const char *status = NULL;
+            if (check) {
+                status = verified[row] < 0 ? "n/a" : verified[row] ? "ok" : "mismatch";
+                if (verified[row] == 0) failed = 1;
+            }
+            printBenchRow(engineLabel(engineList[e]), n, moves, &table[row],
+                          perfEnabled ? &perf : NULL, status, json);
+        }
+    }
+    
+    free(table);
+    free(verified);
+    return failed;
+}
+
+// Headless iterative solve with checkpoints; exit status 3 when interrupted
+int runIterate(int n, const char *checkpointPath, int resume, int json) {
+    char defaultPath[64];
+    IterativeRun run;
+    
+    if (n < 1 || n > CHECKPOINT_MAX_DISKS) {
+        fprintf(stderr, "--iterate needs 1 <= N <= %d\n", CHECKPOINT_MAX_DISKS);
+        return 2;
+    }
+    if (!checkpointPath) {
+        defaultCheckpointPath(n, defaultPath, sizeof(defaultPath));
+        checkpointPath = defaultPath;
+    }
+    if (iterativeRun(n, checkpointPath, resume, 0, &run) != 0) return 1;
+    
+    const char *status = !run.finalStateOk ? "error" : run.interrupted ? "interrupted" : "complete";
+    double mps = (run.seconds > 0) ? run.done / run.seconds : 0.0;
+    if (json) {
+        printf("{\"n\":%d,\"moves\":%lld,\"done\":%lld,\"resumed_from\":%lld,\"seconds\":%.6f,"
+               "\"moves_per_sec\":%.0f,\"checkpoints\":%d,\"status\":\"%s\"}\n",
+               n, run.total, run.done, run.resumedFrom, run.seconds, mps, run.checkpoints, status);
+    } else {
+        printf("n,moves,done,resumed_from,seconds,moves_per_sec,checkpoints,status\n");
+        printf("%d,%lld,%lld,%lld,%.6f,%.0f,%d,%s\n",
+               n, run.total, run.done, run.resumedFrom, run.seconds, mps, run.checkpoints, status);
+    }
+    if (!run.finalStateOk) return 1;
+    return run.interrupted ? 3 : 0;
+}
+
+// Validate the stream of an engine (block, kernel, cursor, simd, recursive,
+// parallel) or of a file: a move trace, a text move list, or "-" for text
+// on stdin
+int runValidate(int n, const char *source, const char *fromText, const char *toText, int threads, int json) {
+    int start[HANOI_VALIDATE_MAX_DISKS + 1], target[HANOI_VALIDATE_MAX_DISKS + 1];
+    HanoiValidator v;
+    HanoiTraceReader reader;
+    int isTrace = 0;
+    
+    if (findEngine(source) < 0 && hanoiTraceReaderOpen(&reader, source)) {
+        isTrace = 1;
+        n = (int)reader.header->disks;
+        for (int d = 1; d <= n; d++) {
+            for (int p = 0; p < 3; p++) {
+                if (reader.header->startPeg[p] >> (d - 1) & 1) start[d] = p;
+            }
+        }
+    }
+    
+    if (n < 1 || n > HANOI_VALIDATE_MAX_DISKS) {
+        fprintf(stderr, "Validation needs 1 <= N <= %d\n", HANOI_VALIDATE_MAX_DISKS);
+        if (isTrace) hanoiTraceReaderClose(&reader);
+        return 2;
+    }
+    if ((fromText && hanoiParseConfig(fromText, start, n) != n) || (toText && hanoiParseConfig(toText, target, n) != n)) {
+        fprintf(stderr, "--from and --to must have one peg letter per disk (%d)\n", n);
+        if (isTrace) hanoiTraceReaderClose(&reader);
+        return 2;
+    }
+    if (!hanoiValidatorInit(&v, n, (isTrace || fromText) ? start : NULL, toText ? target : NULL, threads)) {
+        fprintf(stderr, "Out of memory\n");
+        if (isTrace) hanoiTraceReaderClose(&reader);
+        return 1;
+    }
+    
+    long long t0 = hanoiNowNs();
+    int engine = findEngine(source);
+    int readable = 1;
+    
+    if (isTrace) {
+        hanoiValidateTrace(&v, &reader);
+        hanoiTraceReaderClose(&reader);
+    } else if (engine >= 0) {
+        unsigned long long total = (1ULL << n) - 1;
+        if (fromText) {
+            fprintf(stderr, "Engine streams always start with all disks on A\n");
+            hanoiValidatorFinish(&v);
+            return 2;
+        }
+        if (engines[engine].solve == hanoiSolveBlockDoubling || engines[engine].solve == hanoiSolveKernel) {
+            HanoiPackedMove *chunk = (HanoiPackedMove *)malloc(HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove));
+            if (n <= HANOI_KERNEL_MAX_DISKS && engines[engine].solve == hanoiSolveKernel) {
+                hanoiValidatorPush(&v, hanoiKernelTable(n), (size_t)total);
+            } else if (chunk) {
+                hanoiBlockGenerate(n, chunk, HANOI_BLOCK_CHUNK_MOVES, hanoiValidatorFlush, &v);
+            }
+            free(chunk);
+        } else if (engines[engine].solve == hanoiSolveCursor) {
+            HanoiPackedMove *chunk = (HanoiPackedMove *)malloc(HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove));
+            HanoiCursor cursor;
+            size_t got;
+            hanoiCursorInit(&cursor, n);
+            while (chunk && (got = hanoiCursorFill(&cursor, chunk, HANOI_BLOCK_CHUNK_MOVES)) > 0) {
+                hanoiValidatorPush(&v, chunk, got);
+            }
+            free(chunk);
+        } else if (engines[engine].solve == hanoiSolveSimd) {
+            HanoiPackedMove *chunk = (HanoiPackedMove *)malloc(HANOI_BLOCK_CHUNK_MOVES * sizeof(HanoiPackedMove));
+            unsigned long long next = 1;
+            size_t got;
+            while (chunk && (got = hanoiGrayCodeFill(n, next, chunk, HANOI_BLOCK_CHUNK_MOVES)) > 0) {
+                hanoiValidatorPush(&v, chunk, got);
+                next += got;
+            }
+            free(chunk);
+        } else if ((engines[engine].solve == solveRecursive || engines[engine].solve == hanoiSolveParallel) && n <= 26) {
+            // These engines write the whole list at once
+            HanoiPackedMove *out = (HanoiPackedMove *)malloc(total * sizeof(HanoiPackedMove));
+            if (out) {
+                if (engines[engine].solve == solveRecursive) {
+                    HanoiContext ctx = { 0, out };
+                    hanoi(&ctx, n, 'A', 'C', 'B');
+                } else {
+                    hanoiParallel(n, threads, out);
+                }
+                hanoiValidatorPush(&v, out, (size_t)total);
+                free(out);
+            }
+        } else {
+            fprintf(stderr, "Engine '%s' has no move stream to validate here (block, kernel,\n"
+                            "cursor and simd stream any size, recursive and parallel up to 26 disks)\n", source);
+            hanoiValidatorFinish(&v);
+            return 2;
+        }
+    } else {
+        FILE *f = strcmp(source, "-") == 0 ? stdin : fopen(source, "r");
+        if (!f) {
+            fprintf(stderr, "Cannot open '%s'\n", source);
+            hanoiValidatorFinish(&v);
+            return 1;
+        }
+        readable = hanoiValidateText(&v, f);
+        if (f != stdin) fclose(f);
+    }
+    
+    unsigned long long moves = v.validated + v.used;
+    int ok = hanoiValidatorFinish(&v) && readable;
+    double seconds = (hanoiNowNs() - t0) / 1e9;
+    double rate = seconds > 0 ? moves / seconds : 0.0;
+    const char *reason = !readable ? "malformed input line" : v.reason ? v.reason : "";
+    
+    if (json) {
+        printf("{\"source\":\"%s\",\"n\":%d,\"moves\":%llu,\"threads\":%d,\"seconds\":%.6f,"
+               "\"moves_per_sec\":%.0f,\"valid\":%s,\"first_bad_move\":%llu,\"reason\":\"%s\"}\n",
+               source, n, moves, v.threads, seconds, rate, ok ? "true" : "false", v.firstBad, reason);
+    } else {
+        printf("source,n,moves,threads,seconds,moves_per_sec,valid,first_bad_move,reason\n");
+        printf("%s,%d,%llu,%d,%.6f,%.0f,%s,%llu,%s\n",
+               source, n, moves, v.threads, seconds, rate, ok ? "yes" : "no", v.firstBad, reason);
+    }
+    return ok ? 0 : 1;
+}
+
+int runTraceWrite(int n, const char *path, int engine) {
+    HanoiTraceWriter writer;
+    
+    if (n < 1 || n > 62) {
+        fprintf(stderr, "Trace needs 1 <= N <= 62\n");
+        return 2;
+    }
+    if (engine < 0 || engine > 1) {
+        fprintf(stderr, "Traces are written by the recursive or iterative engine\n");
+        return 2;
+    }
+    if (!hanoiTraceWriterOpen(&writer, path, n, NULL)) {
+        fprintf(stderr, "Cannot create trace file '%s'\n", path);
+        return 1;
+    }
+    
+    long long start = hanoiNowNs();
+    if (engine == 0) {
+        hanoiTrace(n, 'A', 'C', 'B', &writer);
+    } else if (!hanoiIterativeTrace(n, &writer)) {
+        hanoiTraceWriterClose(&writer);
+        remove(path);
+        fprintf(stderr, "Out of memory allocating the pegs\n");
+        return 1;
+    }
+    unsigned long long moves = writer.header.totalMoves;
+    
+    int outOfMemory = writer.failed;
+    if (!hanoiTraceWriterClose(&writer)) {
+        remove(path);
+        fprintf(stderr, outOfMemory ? "Out of memory growing the block index of '%s'\n"
+                                    : "Error while writing trace file '%s'\n", path);
+        return 1;
+    }
+    double seconds = (hanoiNowNs() - start) / 1e9;
+    
+    fprintf(stderr, "Wrote %llu moves to %s in %.3f s (%.0f moves/sec)\n",
+            moves, path, seconds, seconds > 0 ? moves / seconds : 0.0);
+    return 0;
+}
+
+int runTraceRead(const char *path, unsigned long long first, unsigned long long count, int json) {
+    HanoiTraceReader reader;
+    
+    if (!hanoiTraceReaderOpen(&reader, path)) {
+        fprintf(stderr, "Cannot map '%s' as a move trace\n", path);
+        return 1;
+    }
+    
+    unsigned long long total = reader.header->totalMoves;
+    if (first < 1 || first > total) {
+        fprintf(stderr, "Move %llu is outside the trace (1-%llu)\n", first, total);
+        hanoiTraceReaderClose(&reader);
+        return 2;
+    }
+    
+    HanoiMove chunk[4096];
+    unsigned long long k = first - 1;
+    unsigned long long remaining = count;
+    
+    if (!json) printf("step,disk,from,to\n");
+    while (remaining > 0) {
+        unsigned long long want = remaining < 4096 ? remaining : 4096;
+        unsigned long long got = hanoiTraceReadMoves(&reader, k, want, chunk);
+        if (got == 0) break;
+        
+        for (unsigned long long i = 0; i < got; i++) {
+            if (json) {
+                printf("{\"step\":%llu,\"disk\":%d,\"from\":\"%c\",\"to\":\"%c\"}\n",
+                       k + i + 1, chunk[i].disk, 'A' + chunk[i].from, 'A' + chunk[i].to);
+            } else {
+                printf("%llu,%d,%c,%c\n", k + i + 1, chunk[i].disk, 'A' + chunk[i].from, 'A' + chunk[i].to);
+            }
+        }
+        k += got;
+        remaining -= got;
+    }
+    
+    hanoiTraceReaderClose(&reader);
+    return 0;
+}
+
+int runFrameStewartCount(unsigned long long n, int p, int json) {
+    if (p < HANOI_FS_MIN_PEGS || p > HANOI_FS_MAX_PEGS) {
+        fprintf(stderr, "Peg count must be %d-%d\n", HANOI_FS_MIN_PEGS, HANOI_FS_MAX_PEGS);
+        return 2;
+    }
+    
+    unsigned long long count = hanoiFrameStewartCount(n, p);
+    char text[32];
+    if (count == HANOI_FS_SATURATED) snprintf(text, sizeof(text), "overflow");
+    else snprintf(text, sizeof(text), "%llu", count);
+    
+    int split = 0;
+    if (n <= HANOI_FS_MAX_DISKS) split = hanoiFrameStewartSplit((int)n, p);
+    
+    if (json) {
+        printf("{\"n\":%llu,\"pegs\":%d,\"moves\":%s%s%s", n, p,
+               count == HANOI_FS_SATURATED ? "\"" : "", text, count == HANOI_FS_SATURATED ? "\"" : "");
+        if (split) printf(",\"split\":%d", split);
+        printf("}\n");
+    } else {
+        printf("n,pegs,moves,split\n%llu,%d,%s,", n, p, text);
+        if (split) printf("%d", split);
+        printf("\n");
+    }
+    return 0;
+}
+
+int runBfs(int n, const char *fromText, const char *toText, int threads, int json) {
+    int start[64], target[64];
+    
+    if (n < 1 || n > HANOI_BFS_MAX_DISKS) {
+        fprintf(stderr, "BFS needs 1 <= N <= %d\n", HANOI_BFS_MAX_DISKS);
+        return 2;
+    }
+    for (int d = 1; d <= n; d++) start[d] = 0;
+    if (fromText && hanoiParseConfig(fromText, start, 63) != n) {
+        fprintf(stderr, "--from must have exactly %d peg letters\n", n);
+        return 2;
+    }
+    if (toText && hanoiParseConfig(toText, target, 63) != n) {
+        fprintf(stderr, "--to must have exactly %d peg letters\n", n);
+        return 2;
+    }
+    
+    HanoiBfsResult result;
+    unsigned long long *levelSizes = NULL;
+    if (!hanoiBfsExplore(n, start, toText ? target : NULL, threads, &result, &levelSizes)) {
+        fprintf(stderr, "Not enough memory for a BFS over 3^%d states\n", n);
+        return 1;
+    }
+    
+    double rate = result.seconds > 0 ? result.states / result.seconds : 0.0;
+    unsigned long long widest = 0;
+    for (long long l = 0; l <= result.levels; l++) {
+        if (levelSizes[l] > widest) widest = levelSizes[l];
+    }
+    
+    if (json) {
+        printf("{\"n\":%d,\"threads\":%d,\"states\":%llu,\"levels\":%lld,\"widest_level\":%llu,"
+               "\"seconds\":%.6f,\"states_per_sec\":%.0f,\"states_per_sec_per_thread\":[",
+               n, result.threads, result.states, result.levels, widest, result.seconds, rate);
+        for (int t = 0; t < result.threads; t++) {
+            printf("%s%.0f", t ? "," : "", result.seconds > 0 ? result.expanded[t] / result.seconds : 0.0);
+        }
+        printf("]");
+        if (toText) printf(",\"target_distance\":%lld", result.targetDistance);
+        printf("}\n");
+    } else {
+        printf("n,threads,states,levels,widest_level,seconds,states_per_sec,target_distance\n");
+        printf("%d,%d,%llu,%lld,%llu,%.6f,%.0f,", n, result.threads, result.states, result.levels,
+               widest, result.seconds, rate);
+        if (toText) printf("%lld", result.targetDistance);
+        printf("\n\nthread,states_expanded,states_per_sec\n");
+        for (int t = 0; t < result.threads; t++) {
+            printf("%d,%llu,%.0f\n", t, result.expanded[t],
+                   result.seconds > 0 ? result.expanded[t] / result.seconds : 0.0);
+        }
+    }
+    
+    free(levelSizes);
+    return 0;
+}
+
+int runHeadless(int argc, char *argv[]) {
+    int engine = 0;
+    int minDisks = 1;
+    int maxDisks = 20;
+    int repeats = BATCH_MIN_SAMPLES;
+    int json = 0;
+    int moveDisks = 0;
+    int countDisks = 0;
+    int variant = -1;
+    int stateDisks = 0;
+    unsigned long long moveIndex = 0;
+    HanoiMoveIndex queryIndex = 0;
+    int rangeDisks = 0;
+    HanoiMoveIndex rangeEnd = 0;
+    const char *rankConfig = NULL;
+    const char *solveStart = NULL;
+    const char *solveTarget = NULL;
+    int countOnly = 0;
+    int check = 0;
+    int scheduled = 0;
+    int traceDisks = 0;
+    const char *traceWritePath = NULL;
+    const char *traceReadPath = NULL;
+    unsigned long long traceCount = 0;
+    int servePort = 0;
+    const char *daemonPath = NULL;
+    int cacheMb = DAEMON_CACHE_MB;
+    unsigned long long fsDisks = 0;
+    int fsPegs = 0;
+    int bfsDisks = 0;
+    int iterateDisks = 0;
+    int validateDisks = 0;
+    const char *validateSource = NULL;
+    const char *distanceSource = NULL;
+    int suite = 0;
+    const char *baselinePath = NULL;
+    const char *saveBaselinePath = NULL;
+    int threshold = 5;
+    const char *checkpointPath = NULL;
+    int resume = 0;
+    int threadList[HANOI_MAX_THREADS] = { hanoiHardwareThreads() };
+    int threadCount = 1;
+    const char *fromConfig = NULL;
+    const char *toConfig = NULL;
+    const char *serveRoot = VISUALIZER_ROOT;
+    
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--engine") == 0 && value) {
+            engine = strcmp(value, "all") == 0 ? -1 : findEngine(value);
+            if (engine < 0 && strcmp(value, "all") != 0) {
+                fprintf(stderr, "Unknown engine '%s'\n", value);
+                return 2;
+            }
+            i++;
+        } else if (strcmp(arg, "--min") == 0 && value) {
+            if (!parseIntArg(value, &minDisks)) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--max") == 0 && value) {
+            if (!parseIntArg(value, &maxDisks)) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--repeat") == 0 && value) {
+            if (!parseIntArg(value, &repeats)) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--format") == 0 && value) {
+            if (strcmp(value, "json") == 0) json = 1;
+            else if (strcmp(value, "csv") == 0) json = 0;
+            else goto badValue;
+            i++;
+        } else if (strcmp(arg, "--move") == 0 && value && i + 2 < argc) {
+            if (!parseIntArg(value, &moveDisks) || moveDisks < 1) goto badValue;
+            value = argv[i + 2];
+            if (!hanoiParseMoveIndex(value, &queryIndex)) goto badValue;
+            i += 2;
+        } else if (strcmp(arg, "--count") == 0 && value) {
+            if (!parseIntArg(value, &countDisks) || countDisks < 1) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--variant") == 0 && value) {
+            variant = hanoiParseVariant(value);
+            if (variant < 0) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--state") == 0 && value && i + 2 < argc) {
+            if (!parseIntArg(value, &stateDisks) || stateDisks < 1) goto badValue;
+            value = argv[i + 2];
+            if (!hanoiParseMoveIndex(value, &queryIndex)) goto badValue;
+            i += 2;
+        } else if (strcmp(arg, "--range") == 0 && value && i + 3 < argc) {
+            if (!parseIntArg(value, &rangeDisks) || rangeDisks < 1) goto badValue;
+            value = argv[i + 2];
+            if (!hanoiParseMoveIndex(value, &queryIndex)) goto badValue;
+            value = argv[i + 3];
+            if (!hanoiParseMoveIndex(value, &rangeEnd)) goto badValue;
+            i += 3;
+        } else if (strcmp(arg, "--solve") == 0 && value && i + 2 < argc) {
+            solveStart = value;
+            solveTarget = argv[i + 2];
+            i += 2;
+        } else if (strcmp(arg, "--distances") == 0 && value) {
+            distanceSource = value;
+            i++;
+        } else if (strcmp(arg, "--count-only") == 0) {
+            countOnly = 1;
+        } else if (strcmp(arg, "--validate") == 0 && value && i + 2 < argc) {
+            if (!parseIntArg(value, &validateDisks)) goto badValue;
+            validateSource = argv[i + 2];
+            i += 2;
+        } else if (strcmp(arg, "--suite") == 0) {
+            suite = 1;
+        } else if (strcmp(arg, "--baseline") == 0 && value) {
+            baselinePath = value;
+            i++;
+        } else if (strcmp(arg, "--save-baseline") == 0 && value) {
+            saveBaselinePath = value;
+            i++;
+        } else if (strcmp(arg, "--threshold") == 0 && value) {
+            if (!parseIntArg(value, &threshold)) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--iterate") == 0 && value) {
+            if (!parseIntArg(value, &iterateDisks) || iterateDisks < 1) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--checkpoint") == 0 && value) {
+            checkpointPath = value;
+            i++;
+        } else if (strcmp(arg, "--resume") == 0) {
+            resume = 1;
+        } else if (strcmp(arg, "--workers") == 0 && value) {
+            if (!parseIntArg(value, &batchWorkers) || batchWorkers < 0) goto badValue;
+            scheduled = 1;
+            i++;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            batchQuiet = 1;
+            scheduled = 1;
+        } else if (strcmp(arg, "--perf") == 0) {
+            perfEnabled = 1;
+        } else if (strcmp(arg, "--check") == 0) {
+            check = 1;
+        } else if (strcmp(arg, "--trace-write") == 0 && value && i + 2 < argc) {
+            if (!parseIntArg(value, &traceDisks)) goto badValue;
+            traceWritePath = argv[i + 2];
+            i += 2;
+        } else if (strcmp(arg, "--trace-read") == 0 && value && i + 3 < argc) {
+            traceReadPath = value;
+            value = argv[i + 2];
+            if (!parseULLArg(value, &moveIndex)) goto badValue;
+            value = argv[i + 3];
+            if (!parseULLArg(value, &traceCount)) goto badValue;
+            i += 3;
+        } else if (strcmp(arg, "--serve") == 0 && value) {
+            if (!parseIntArg(value, &servePort) || servePort < 1 || servePort > 65535) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--daemon") == 0 && value) {
+            daemonPath = value;
+            i++;
+        } else if (strcmp(arg, "--cache-mb") == 0 && value) {
+            if (!parseIntArg(value, &cacheMb) || cacheMb < 1) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--root") == 0 && value) {
+            serveRoot = value;
+            i++;
+        } else if (strcmp(arg, "--pegs") == 0 && value) {
+            if (!parseIntArg(value, &hanoiFrameStewartPegs) || hanoiFrameStewartPegs < HANOI_FS_MIN_PEGS
+                || hanoiFrameStewartPegs > HANOI_FS_MAX_PEGS) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--simd") == 0 && value) {
+            hanoiSimdPath = hanoiParseSimdPath(value);
+            if (hanoiSimdPath != SIMD_AUTO && !hanoiSimdPathSupported(hanoiSimdPath)) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--fs-count") == 0 && value && i + 2 < argc) {
+            if (!parseULLArg(value, &fsDisks)) goto badValue;
+            value = argv[i + 2];
+            if (!parseIntArg(value, &fsPegs)) goto badValue;
+            i += 2;
+        } else if (strcmp(arg, "--bfs") == 0 && value) {
+            if (!parseIntArg(value, &bfsDisks) || bfsDisks < 1) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--from") == 0 && value) {
+            fromConfig = value;
+            i++;
+        } else if (strcmp(arg, "--to") == 0 && value) {
+            toConfig = value;
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            threadCount = parseThreadList(value, threadList, HANOI_MAX_THREADS);
+            if (threadCount == 0) goto badValue;
+            i++;
+        } else if (strcmp(arg, "--rank") == 0 && value) {
+            rankConfig = value;
+            i++;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option '%s'\n\n", arg);
+            printUsage(argv[0]);
+            return 2;
+        }
+        continue;
+        
+    badValue:
+        fprintf(stderr, "Invalid value '%s' for %s\n", value, arg);
+        return 2;
+    }
+    
+    if (moveDisks > 0) {
+        return runMoveQuery(moveDisks, queryIndex, variant, json);
+    }
+    if (countDisks > 0) {
+        return runCountQuery(countDisks, variant, json);
+    }
+    if (stateDisks > 0) {
+        return runStateQuery(stateDisks, queryIndex, json);
+    }
+    if (rangeDisks > 0) {
+        return runRange(rangeDisks, queryIndex, rangeEnd, json);
+    }
+    if (rankConfig) {
+        return runRankQuery(rankConfig, json);
+    }
+    if (solveStart) {
+        return runSolveQuery(solveStart, solveTarget, countOnly, json);
+    }
+    if (distanceSource) {
+        return runDistanceOracle(distanceSource, threadList[0], json);
+    }
+    if (traceWritePath) {
+        return runTraceWrite(traceDisks, traceWritePath, engine);
+    }
+    if (traceReadPath) {
+        return runTraceRead(traceReadPath, moveIndex, traceCount, json);
+    }
+    if (fsPegs) {
+        return runFrameStewartCount(fsDisks, fsPegs, json);
+    }
+    if (bfsDisks) {
+        return runBfs(bfsDisks, fromConfig, toConfig, threadList[0], json);
+    }
+    if (iterateDisks) {
+        return runIterate(iterateDisks, checkpointPath, resume, json);
+    }
+    if (suite) {
+        return runSuite(repeats, json, baselinePath, saveBaselinePath, threshold);
+    }
+    if (validateSource) {
+        return runValidate(validateDisks, validateSource, fromConfig, toConfig, threadList[0], json);
+    }
+    if (servePort) {
+        #ifdef _WIN32
+        fprintf(stderr, "The built-in server is not available on Windows, use dist\\run.bat\n");
+        return 2;
+        #else
+        return serveVisualizer(servePort, serveRoot);
+        #endif
+    }
+    if (daemonPath) {
+        #ifdef _WIN32
+        fprintf(stderr, "The solver daemon needs Unix domain sockets and is not available on Windows\n");
+        return 2;
+        #else
+        return runDaemon(daemonPath, threadList[0], cacheMb);
+        #endif
+    }
+    
+    if (minDisks < 1 || maxDisks < minDisks || maxDisks > 62 || repeats < 1) {
+        fprintf(stderr, "Disk range must satisfy 1 <= min <= max <= 62 and repeat >= 1\n");
+        return 2;
+    }
+    
+    if (scheduled || engine < 0) {
+        hanoiParallelThreads = threadList[0];
+        return runScheduledBenchmark(engine, minDisks, maxDisks, repeats, json, check);
+    }
+    return runHeadlessBenchmark(engine, minDisks, maxDisks, repeats, json, check, threadList, threadCount);
+}
+
+// ═══════════════════════════════════════════════════════════
+//  MAIN FUNCTION
+// ═══════════════════════════════════════════════════════════
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        return runHeadless(argc, argv);
+    }
+    
+    enableVirtualTerminal();
+    int choice;
+    
+    while (1) {
+        clearScreen();
+        printHeader();
+        
+        printf("  %s1.%s %sRecursive Version%s   - Classic recursive solution\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s2.%s %sIterative Version%s   - Stack-based iterative solution\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s3.%s %sVisualizer%s          - Launch graphical interface\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s4.%s %sEngine Lab%s          - Batch test any engine\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        printf("  %s0.%s %sExit%s                - Close the program\n", 
+               BRIGHT_CYAN, RESET, BRIGHT_WHITE, RESET);
+        
+        printf("\n");
+        printSeparator(BRIGHT_BLACK);
+        printf("%s  Enter your choice: %s", BRIGHT_YELLOW, RESET);
+        
+        if (scanf("%d", &choice) != 1) {
+            while(getchar() != '\n');
+            choice = -1;
+        }
+        
+        switch (choice) {
+            case 1:
+                recursiveMenu();
+                break;
+                
+            case 2:
+                iterativeMenu();
+                break;
+                
+            case 3:
+                launchVisualizer();
+                break;
+                
+            case 4:
+                runEngineLab();
+                break;
+                
+            case 0:
+                clearScreen();
+                printf("\n");
+                printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s|                   Thanks for using!                        |%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s|               Tower of Hanoi Solver v2.0                  |%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s|                                                            |%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("%s%s+============================================================+%s\n", BOLD, BRIGHT_CYAN, RESET);
+                printf("\n");
+                return 0;
+                
+            default:
+                printf("\n%s  Warning: Invalid choice! Please try again.%s\n", 
+                       BRIGHT_RED, RESET);
+                pressAnyKey();
+        }
+    }
+    
+    return 0;
+}
+
+